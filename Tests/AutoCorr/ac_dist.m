@@ -33,30 +33,11 @@
 
 
 
-fmt = '%f';
-DATA = [];
-sizeDATA = [1, inf];
-
 %  --------------------------    Read Data    --------------------------
 
-	%  'data_file.dat' should be in the same directory as this MatLab file
-fileID = fopen('datafile.dat', 'r');
-
-if (fileID == -1)
-    disp('Error: Could not open file.')
-else
-    while ~feof(fileID)
-        DATA = fscanf(fileID, fmt, sizeDATA);        
-    end
-    
-    closeresult = fclose(fileID);
-    if closeresult ~= 0
-        disp('Error: Could not close file.')
-    end
-end
-
-	% clean up
-clear closeresult fileID fmt sizeDATA
+	%  'datafile.dat' should be in the same directory as this MatLab file, and so
+	%  should read_dataset.m from the Dataset folder.
+[DATA, INFO] = read_dataset('datafile.dat');
 
 
 %  --------     prepare data for the overlaying normal curve    --------
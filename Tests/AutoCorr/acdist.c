@@ -8,14 +8,20 @@
  *      Draw 10000 samples with sample size 400, compute the autocorrelation lag 1 and store
  *      the results in a datafile to be analyzed in MatLab.
  *
+ * Usage:
+ *      acdist [samples [size [lags]]]
+ *
+ *      By default 10000 samples of 400 numbers and lag 1. The distribution of the
+ *      autocorrelations at lags 1 - lags is summarized on screen, and the autocorrelations
+ *      lag 1 are stored in datafile.dat, in the binary format of dataset.c, if there are at
+ *      most 10^8 samples.
+ *
  * Compilation:
  *     From the command line with Microsoft (R) Macro Assembler and 
  *                                Microsoft (R) C/C++ Optimizing Compiler.
  *
- *      1. Assemble rng.asm without linking using the command
- *         ml /c rng.asm
- *      2. Compile and link the program using the command
- *         cl acdist.c rng.obj
+ *      1. Compile and link the program using the command
+ *         cl /O2 /arch:AVX2 /openmp acdist.c generator.c statistics.c dataset.c
  *
  * License:
  * 
@@ -39,71 +45,205 @@
  *          OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 
- 
+
 #include <stdio.h>
+#include <stdlib.h>
 #include <math.h>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "dataset.h"
+#include "generator.h"
+#include "statistics.h"
 
 #define SAMPLESIZE     400
 #define    SAMPLES   10000
-
-extern   void randomize(void);
-extern double rndflt(void);
+#define       LAGS       1
+#define      LANES       4						//  samples whose autocovariances are computed together
+#define      GROUP    4096						//  groups of LANES samples computed between aggregations
+#define    FILEMAX 100000000						//  most samples written to the datafile
+#define       SEED  0x13b3e
 
 
 
 /*
- *     A function to calculate the autocovariance with a specific lag
- *     and with known population mean. This functions is designed 
- *     specifically for the problem at hand.
- *
- *     \param *x      pointer to array with data
- *     \param  size   number of elements in the data array
- *     \param  lag    
- *     \param  pmean  population mean of the data in the data array
+ *     A function to calculate the autocovariances of LANES samples at once, with lags
+ *     1 - maxlag and with known population mean.
  *
- *     note:  size means number of elements in the data array, not
- *            number of pairs of xn and xn+lag
+ *     \param *acov   Receives the autocovariances, acov[(lag - 1) * LANES + s] for sample s.
+ *     \param *x      The samples, interleaved, x[i * LANES + s] is number i of sample s,
+ *                    with the population mean already subtracted.
+ *     \param  size   Number of elements in each sample.
+ *     \param  maxlag Largest lag.
  *
- *     note:  population mean is the mean of the population from which
- *            the data sample in *x is drawn from, not the mean of the 
- *            data in x.
+ *     note:  Sample s is lane s of the vectors, so one AVX2 instruction works on all four
+ *            samples, and the loop over the numbers is the same as for one sample.
+ */
+static void acov(double *acov, const double *x, int size, int maxlag)
+{
+	for (int lag = 1; lag <= maxlag; lag++)
+	{
+		const double *y = x + lag * LANES;
+		double       *a = acov + (lag - 1) * LANES;
+		int           n = size - lag;
+#if defined(__AVX2__)
+		__m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd();
+		int     c  = 0;
+		for (; c + 2 <= n; c += 2)
+		{
+			s0 = _mm256_add_pd(s0, _mm256_mul_pd(_mm256_loadu_pd(x + c * LANES), _mm256_loadu_pd(y + c * LANES)));
+			s1 = _mm256_add_pd(s1, _mm256_mul_pd(_mm256_loadu_pd(x + (c + 1) * LANES), _mm256_loadu_pd(y + (c + 1) * LANES)));
+		}
+		if (c < n) s0 = _mm256_add_pd(s0, _mm256_mul_pd(_mm256_loadu_pd(x + c * LANES), _mm256_loadu_pd(y + c * LANES)));
+		_mm256_storeu_pd(a, _mm256_div_pd(_mm256_add_pd(s0, s1), _mm256_set1_pd((double)n)));
+#else
+		double sum[LANES] = {0.0};
+		for (int c = 0; c < n; c++)
+		{
+			for (int s = 0; s < LANES; s++) sum[s] += x[c * LANES + s] * y[c * LANES + s];
+		}
+		for (int s = 0; s < LANES; s++) a[s] = sum[s] / n;
+#endif
+	}
+}
+
+
+
+/*
+ *     Draw LANES samples from their own places in the stream of the generator, subtract
+ *     the population mean and interleave them. Sample s takes the numbers from
+ *     s * size to (s + 1) * size - 1, so the samples do not overlap.
  */
-double acov(double *x, int size, int lag, double pmean)
+static void draw(double *x, double *buffer, long long first, int size, double pmean)
 {
-	double sum = 0.0, *y = x + lag;		
-	for (int c = 0; c < size - lag; c++) sum += (*x++ - pmean) * (*y++ - pmean);
-	return sum / (size - lag);
+	for (int s = 0; s < LANES; s++)
+	{
+		Generator g;
+		generator_init(&g, SEED);
+		generator_jump(&g, (unsigned long long)(first + s) * size);
+		generator_fill_flt(&g, buffer, size);
+		for (int c = 0; c < size; c++) x[c * LANES + s] = buffer[c] - pmean;
+	}
 }
 
 
 
-int main(void)
+int main(int argc, char *argv[])
 {
+	long long samples = (argc > 1) ? strtoll(argv[1], NULL, 0) : SAMPLES;
+	int       size    = (argc > 2) ? atoi(argv[2]) : SAMPLESIZE;
+	int       lags    = (argc > 3) ? atoi(argv[3]) : LAGS;
+	if (argc > 4 || samples < 1 || size < 2 || lags < 1 || lags >= size)
+	{
+		printf("\n    Usage: acdist [samples [size [lags]]], 1 <= lags < size\n\n");
+		return 1;
+	}
+
 		//  the population mean and variance are known.
 	double pop_mean = 0.5;
 	double pop_var  = 1.0 / 12.0;
-	
-	double *data = (double*)malloc(SAMPLESIZE * sizeof(double));
-	double *ptr;
-	
-		//  specify data format and open file for writing
-	char *format = "%7.4f\n";
-	FILE *fp;
-	fp = fopen("datafile.dat", "w");	
-	
-		//  draw 10000 samples, calculate the autocorrelation lag 1 and store in file.
-	for (int c = 0; c < SAMPLES; c++)
+
+	long long    groups = (samples + LANES - 1) / LANES;
+	double      *r      = (double *)malloc(GROUP * LANES * (size_t)lags * sizeof(double));
+	double      *lag1   = (double *)malloc(GROUP * LANES * sizeof(double));
+	Accumulator *acc    = (Accumulator *)malloc(lags * sizeof(Accumulator));
+	long long   *tail   = (long long *)calloc(2 * (size_t)lags, sizeof(long long));
+	if (r == NULL || lag1 == NULL || acc == NULL || tail == NULL)
+	{
+		free(tail);
+		free(acc);
+		free(lag1);
+		free(r);
+		printf("\n    Unable to allocate memory.\n\n");
+		return 1;
+	}
+	for (int k = 0; k < lags; k++) statistics_acc_init(&acc[k]);
+
+	if ((double)samples * size > 2147483648.0) printf("\n    Note: the samples take more than the period of the generator and repeat.\n");
+
+		//  open file for writing, one autocorrelation lag 1 per row
+	DatasetWriter w;
+	int           file = 0;
+	if (samples <= FILEMAX)
 	{
-		randomize();
-		ptr = data;
-		for (int c = 0; c < SAMPLESIZE; c++) *ptr++ = rndflt();
-		
-			//  divide by pop. variance to get autocorrelation.
-		fprintf(fp, format, acov(data, SAMPLESIZE, 1, pop_mean) / pop_var);
-	}		
-	
-		//  close file, free memory and end program	
-	fclose(fp);
-	free(data);
+		file = dataset_create(&w, "datafile.dat", DS_F64, 1, SEED) == 0;
+		if (!file) printf("\n    Unable to write datafile.dat.\n");
+	}
+
+		//  draw the samples in groups, in parallel, and aggregate the autocorrelations in order
+	for (long long first = 0; first < groups; first += GROUP)
+	{
+		int count = (groups - first < GROUP) ? (int)(groups - first) : GROUP;
+		int fail  = 0;
+
+#pragma omp parallel for schedule(dynamic)
+		for (int i = 0; i < count; i++)
+		{
+			double *x      = (double *)malloc(LANES * (size_t)size * sizeof(double));
+			double *buffer = (double *)malloc((size_t)size * sizeof(double));
+			if (x == NULL || buffer == NULL)
+			{
+#pragma omp atomic write
+				fail = 1;
+			}
+			else
+			{
+				draw(x, buffer, (first + i) * LANES, size, pop_mean);
+				acov(r + (size_t)i * LANES * lags, x, size, lags);
+			}
+			free(x);
+			free(buffer);
+		}
+		if (fail)
+		{
+			if (file) dataset_close(&w);
+			free(tail);
+			free(acc);
+			free(lag1);
+			free(r);
+			printf("\n    Unable to allocate memory.\n\n");
+			return 1;
+		}
+
+		size_t n1 = 0;
+		for (int i = 0; i < count; i++)
+		{
+			for (int s = 0; s < LANES && (first + i) * LANES + s < samples; s++)
+			{
+				for (int k = 0; k < lags; k++)
+				{
+						//  divide by pop. variance to get autocorrelation, and by its standard error
+					double rho = r[((size_t)i * lags + k) * LANES + s] / pop_var;
+					double z   = fabs(rho) * sqrt(size - k - 1.0);
+					statistics_acc_add(&acc[k], rho);
+					tail[2 * k]     += (z > 1.959963984540054);
+					tail[2 * k + 1] += (z > 2.575829303548901);
+					if (k == 0) lag1[n1++] = rho;
+				}
+			}
+		}
+		if (file == 1 && dataset_write(&w, lag1, n1) != 0) file = 2;		//  2: stop writing, report it at the end
+	}
+	if (file && (dataset_close(&w) != 0 || file == 2)) printf("\n    Unable to write datafile.dat.\n");
+
+		//  present the distribution of the autocorrelations
+	printf("\n\n    %lld samples of %d numbers\n\n", samples, size);
+	printf("    %4s %10s %10s %10s %8s %8s %8s %8s\n", "lag", "mean", "std", "1/sqrt(n)", "skew", "kurt", "> 1.96", "> 2.58");
+	puts("    ------------------------------------------------------------------------------");
+	for (int k = 0; k < lags; k++)
+	{
+		printf("    %4d %10.6f %10.6f %10.6f %8.4f %8.4f %7.3f%% %7.3f%%\n", k + 1, statistics_acc_mean(&acc[k]),
+		       statistics_acc_std(&acc[k], ST_SAMPLE), 1.0 / sqrt(size - k - 1.0), statistics_acc_skew(&acc[k]),
+		       statistics_acc_kurt(&acc[k]), 100.0 * tail[2 * k] / samples, 100.0 * tail[2 * k + 1] / samples);
+	}
+	puts("    ------------------------------------------------------------------------------");
+	printf("    The autocorrelations should have mean 0 and standard deviation 1/sqrt(n), n the number\n");
+	printf("    of pairs, and 5%% and 1%% of them should be more than 1.96 and 2.58 standard deviations out.\n\n");
+
+	free(tail);
+	free(acc);
+	free(lag1);
+	free(r);
 	return 0;
 }
@@ -15,7 +15,7 @@
  *      1. Assemble rng.asm without linking using the command
  *         ml /c rng.asm
  *      2. Compile and link the program using the command
- *         cl autocorr.c statistics.c rng.obj
+ *         cl autocorr.c statistics.c acf.c rng.obj
  *
  * License:
  * 
@@ -40,9 +40,11 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <math.h>
 
 #include "statistics.h"
+#include "acf.h"
 
 #define SAMPLESIZE  400
 #define     MAXLAG   20
@@ -60,32 +62,6 @@ extern   void randomize(void);
 extern double rndflt(void);
 
 
-/*
- *     A function to calculate the autocovariance with a specific lag
- *     and with known population mean. This functions is designed 
- *     specifically for the problem at hand.
- *
- *     \param *x      pointer to array with data
- *     \param  size   number of elements in the data array
- *     \param  lag    
- *     \param  pmean  population mean of the data in the data array
- *
- *     note:  size means number of elements in the data array, not
- *            number of pairs of xn and xn+lag
- *
- *     note:  population mean is the mean of the population from which
- *            the data sample in *x is drawn from, not necessarily the 
- *            mean of *x.
- */
-double _acov(double *x, int size, int lag, double pmean)
-{
-	double sum = 0.0, *y = x + lag;		
-	for (int c = 0; c < size - lag; c++) sum += (*x++ - pmean) * (*y++ - pmean);
-	return sum / (size - lag);
-}
-
-
-
 int main(void)
 {
 	randomize();
@@ -98,7 +74,11 @@ int main(void)
 	
 		//  allocate memory for buffers
 	double         *data = (double*)malloc(SAMPLESIZE * sizeof(double));
+	double         *sums = (double*)malloc((MAXLAG + 1) * sizeof(double));
+	double *coefficients = (double*)malloc((MAXLAG + 1) * sizeof(double));
 	double *correlations = (double*)malloc(    MAXLAG * sizeof(double));
+	double       *zscore = (double*)malloc(    MAXLAG * sizeof(double));
+	double      *pvalues = (double*)malloc(    MAXLAG * sizeof(double));
 	double *ptr;
 	
 		//  Generate numbers in the interval [0, 1]. The numbers from rndflt() are raw random numbers divided by rndmax.
@@ -106,8 +86,24 @@ int main(void)
 	for(int c = 0; c < SAMPLESIZE; c++) *ptr++ = rndflt();
 	
 		//  compute correlations
+		//  the sums of the lagged products for all lags at once
+	if (acf_sums(sums, data, SAMPLESIZE, MAXLAG, pop_mean) != 0)
+	{
+		free(data);
+		free(correlations);
+		free(sums);
+		free(coefficients);
+		free(zscore);
+		free(pvalues);
+		printf("\n    Unable to allocate memory.\n\n");
+		return 1;
+	}
 	ptr = correlations;
-	for(int lag = 1; lag <= MAXLAG; lag++) *ptr++ = _acov(data, SAMPLESIZE, lag, pop_mean) / pop_var;
+	for(int lag = 1; lag <= MAXLAG; lag++) *ptr++ = sums[lag] / (SAMPLESIZE - lag) / pop_var;
+	
+		//  p-values of all the coefficients in one call
+	for(int c = 0; c < MAXLAG; c++) zscore[c] = (correlations[c] - pop_corr) / pop_serr;
+	statistics_pnorm_tt_batch(pvalues, zscore, MAXLAG);
 	
 		//  analyze correlations
 	double serr;					//  standard error of the autocorrelation for the sample
@@ -128,7 +124,7 @@ int main(void)
 	{		
 			//  calculate sample parameters
 		lag   = c + 1;		
-		p     = 1 - statistics_cmnorm_tt(-*ptr, *ptr, pop_corr, pop_serr);
+		p     = pvalues[c];
 		serr  = 1 / sqrt(SAMPLESIZE - lag - 1);
 		width = ZSCORE * serr;
 		
@@ -138,10 +134,31 @@ int main(void)
 		ptr++;
 	}
 	puts("-------------------------------------------------------------------------------------");
+	
+		//  portmanteau tests of all the lags together
+	if (acf_correlation(coefficients, data, SAMPLESIZE, MAXLAG) != 0)
+	{
+		free(data);
+		free(correlations);
+		free(sums);
+		free(coefficients);
+		free(zscore);
+		free(pvalues);
+		printf("\n    Unable to allocate memory.\n\n");
+		return 1;
+	}
+	double lb = acf_ljung_box(coefficients, SAMPLESIZE, 1, MAXLAG);
+	double bp = acf_box_pierce(coefficients, SAMPLESIZE, 1, MAXLAG);
+	printf("Ljung-Box  Q = %7.3f   df = %d   P = %6.4f\n", lb, MAXLAG, 1.0 - statistics_cmchisq(lb, MAXLAG));
+	printf("Box-Pierce Q = %7.3f   df = %d   P = %6.4f\n", bp, MAXLAG, 1.0 - statistics_cmchisq(bp, MAXLAG));
 	puts("\n\n\n");
 	
 		//  free memory and end program
 	free(data);
 	free(correlations);
+	free(sums);
+	free(coefficients);
+	free(zscore);
+	free(pvalues);
 	return 0;
 }
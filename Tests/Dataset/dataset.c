@@ -0,0 +1,305 @@
+/*
+ * dataset.c
+ *
+ * Created: 18. Oct. 2026
+ *  Author: Frank Bjørnø
+ *
+ * Purpose:
+ *      Store generated test data in a small self describing binary file, written through a
+ *      large buffer and read back by mapping the file into memory.
+ *
+ * License:
+ *
+ *          Copyright (C) 2026 Frank Bjørnø
+ *
+ *          1. Permission is hereby granted, free of charge, to any person obtaining a copy
+ *          of this software and associated documentation files (the "Software"), to deal
+ *          in the Software without restriction, including without limitation the rights
+ *          to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ *          of the Software, and to permit persons to whom the Software is furnished to do
+ *          so, subject to the following conditions:
+ *
+ *          2. The above copyright notice and this permission notice shall be included in all
+ *          copies or substantial portions of the Software.
+ *
+ *          3. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *          INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ *          PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *          HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ *          CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ *          OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#include "dataset.h"
+#include "generator.h"
+
+
+
+/*
+ *     Number of bytes in a value of a given type, 0 if the type is unknown.
+ */
+size_t dataset_size(DSTYPE type)
+{
+	switch(type)
+	{
+		case DS_U8:  return 1;
+		case DS_U32: return 4;
+		case DS_I32: return 4;
+		case DS_F64: return 8;
+		default:     return 0;
+	}
+}
+
+
+
+/***************************************************************************************************
+ *                                                                                                 *
+ *                                            Writer                                               *
+ *                                                                                                 *
+ ***************************************************************************************************/
+
+/*
+ *     Create a file and prepare to write rows of values to it.
+ *
+ *     \param *w        Pointer to the writer.
+ *     \param *name     Name of the file. An existing file is overwritten.
+ *     \param  type     Type of the values.
+ *     \param  columns  Values in a row, at least 1.
+ *     \param  seed     Seed the data is generated from, stored in the header with the
+ *                      parameters of the generator. 0 if the data is not random.
+ *
+ *     \return          0 on success, 1 if the file could not be created or memory could not
+ *                      be allocated, 2 if the type or the number of columns is not valid.
+ *
+ *     Note:  The header is written with 0 rows, and completed by dataset_close.
+ */
+int dataset_create(DatasetWriter *w, const char *name, DSTYPE type, unsigned int columns, unsigned int seed)
+{
+	memset(w, 0, sizeof(DatasetWriter));
+	if (dataset_size(type) == 0 || columns == 0) return 2;
+
+	w -> _size   = dataset_size(type);
+	w -> _buffer = (unsigned char *)malloc(DATASET_BUFFER);
+	w -> _fp     = fopen(name, "wb");
+	if (w -> _buffer == NULL || w -> _fp == NULL)
+	{
+		if (w -> _fp != NULL) fclose(w -> _fp);
+		free(w -> _buffer);
+		memset(w, 0, sizeof(DatasetWriter));
+		return 1;
+	}
+	setvbuf(w -> _fp, NULL, _IONBF, 0);				//  the writer does its own buffering
+
+	DatasetHeader *h = &w -> _header;
+	memcpy(h -> _magic, DATASET_MAGIC, 8);
+	h -> _type    = (uint32_t)type;
+	h -> _columns = columns;
+	h -> _offset  = (sizeof(DatasetHeader) + DATASET_ALIGN - 1) / DATASET_ALIGN * DATASET_ALIGN;
+	h -> _seed    = seed;
+	h -> _a       = GENERATOR_A;
+	h -> _c       = GENERATOR_C;
+	h -> _m       = GENERATOR_M;
+
+		//  the header, padded to the start of the payload
+	memset(w -> _buffer, 0, (size_t)h -> _offset);
+	memcpy(w -> _buffer, h, sizeof(DatasetHeader));
+	w -> _used = (size_t)h -> _offset;
+	return 0;
+}
+
+
+
+/*
+ *     Write the buffer to the file.
+ */
+static int _flush(DatasetWriter *w)
+{
+	if (w -> _used > 0 && fwrite(w -> _buffer, 1, w -> _used, w -> _fp) != w -> _used) return 1;
+	w -> _used = 0;
+	return 0;
+}
+
+
+
+/*
+ *     Write rows of values.
+ *
+ *     \param *w        Pointer to the writer.
+ *     \param *values   rows x columns values of the type of the file, one row after the other.
+ *     \param  rows     Number of rows.
+ *
+ *     \return          0 on success, 1 if the values could not be written.
+ *
+ *     Note:  The values are collected in a buffer of DATASET_BUFFER bytes, and the file is
+ *            written a full buffer at a time, so many small writes cost no more than one
+ *            large. Values that fill the whole buffer by themselves are written directly.
+ */
+int dataset_write(DatasetWriter *w, const void *values, size_t rows)
+{
+	const unsigned char *src = (const unsigned char *)values;
+	size_t               n   = rows * w -> _header._columns * w -> _size;
+
+	if (w -> _fp == NULL) return 1;
+	w -> _header._rows += rows;
+
+	while (n > 0)
+	{
+		if (w -> _used == 0 && n >= DATASET_BUFFER)
+		{
+			size_t m = n / DATASET_BUFFER * DATASET_BUFFER;
+			if (fwrite(src, 1, m, w -> _fp) != m) return 1;
+			src += m, n -= m;
+			continue;
+		}
+
+		size_t m = DATASET_BUFFER - w -> _used;
+		if (m > n) m = n;
+		memcpy(w -> _buffer + w -> _used, src, m);
+		w -> _used += m, src += m, n -= m;
+		if (w -> _used == DATASET_BUFFER && _flush(w)) return 1;
+	}
+	return 0;
+}
+
+
+
+/*
+ *     Write what is left in the buffer, complete the header and close the file.
+ *
+ *     \return     0 on success, 1 if the file could not be written.
+ */
+int dataset_close(DatasetWriter *w)
+{
+	if (w -> _fp == NULL) return 1;
+
+	int fail = _flush(w);
+	fail |= (fseek(w -> _fp, 0, SEEK_SET) != 0);
+	fail |= (fwrite(&w -> _header, sizeof(DatasetHeader), 1, w -> _fp) != 1);
+	fail |= (fclose(w -> _fp) != 0);
+
+	free(w -> _buffer);
+	w -> _fp = NULL, w -> _buffer = NULL;
+	return fail;
+}
+
+
+
+/***************************************************************************************************
+ *                                                                                                 *
+ *                                            Reader                                               *
+ *                                                                                                 *
+ ***************************************************************************************************/
+
+/*
+ *     Map a file into memory.
+ *
+ *     \param *d        Pointer to the dataset.
+ *     \param *name     Name of the file.
+ *
+ *     \return          0 on success, 1 if the file could not be opened or mapped, 2 if it is
+ *                      not a complete dataset.
+ *
+ *     Note:  The file is mapped read only, and d -> _data points to the payload in the
+ *            mapping. The operating system reads the pages when they are used, so a large
+ *            file costs nothing until it is read, and nothing is copied.
+ */
+int dataset_open(Dataset *d, const char *name)
+{
+	memset(d, 0, sizeof(Dataset));
+
+#if defined(_WIN32)
+	HANDLE        file = CreateFileA(name, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	LARGE_INTEGER size;
+	if (file == INVALID_HANDLE_VALUE) return 1;
+	if (!GetFileSizeEx(file, &size))
+	{
+		CloseHandle(file);
+		return 1;
+	}
+	if (size.QuadPart < (LONGLONG)sizeof(DatasetHeader))
+	{
+		CloseHandle(file);
+		return 2;
+	}
+	d -> _handle = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	CloseHandle(file);							//  the mapping keeps the file open
+	if (d -> _handle == NULL) return 1;
+	d -> _map = MapViewOfFile(d -> _handle, FILE_MAP_READ, 0, 0, 0);
+	if (d -> _map == NULL)
+	{
+		CloseHandle(d -> _handle);
+		d -> _handle = NULL;
+		return 1;
+	}
+	d -> _length = (size_t)size.QuadPart;
+#else
+	struct stat st;
+	int fd = open(name, O_RDONLY);
+	if (fd < 0) return 1;
+	if (fstat(fd, &st) != 0)
+	{
+		close(fd);
+		return 1;
+	}
+	if (st.st_size < (off_t)sizeof(DatasetHeader))
+	{
+		close(fd);
+		return 2;
+	}
+	d -> _map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);								//  the mapping keeps the file open
+	if (d -> _map == MAP_FAILED)
+	{
+		d -> _map = NULL;
+		return 1;
+	}
+	d -> _length = (size_t)st.st_size;
+#endif
+
+		//  check the header, and that the file holds all the rows it claims
+	DatasetHeader *h    = &d -> _header;
+	size_t         size = 0;
+	memcpy(h, d -> _map, sizeof(DatasetHeader));
+	if (memcmp(h -> _magic, DATASET_MAGIC, 8) == 0 && h -> _offset % DATASET_ALIGN == 0 && h -> _offset >= sizeof(DatasetHeader))
+	{
+		size = dataset_size((DSTYPE)h -> _type);
+	}
+	if (size == 0 || h -> _columns == 0 || h -> _offset > d -> _length
+	    || h -> _rows > (d -> _length - h -> _offset) / size / h -> _columns)
+	{
+		dataset_free(d);
+		return 2;
+	}
+
+	d -> _data = (const unsigned char *)d -> _map + h -> _offset;
+	return 0;
+}
+
+
+
+/*
+ *     Unmap a file mapped by dataset_open.
+ */
+void dataset_free(Dataset *d)
+{
+#if defined(_WIN32)
+	if (d -> _map != NULL) UnmapViewOfFile(d -> _map);
+	if (d -> _handle != NULL) CloseHandle(d -> _handle);
+#else
+	if (d -> _map != NULL) munmap(d -> _map, d -> _length);
+#endif
+	memset(d, 0, sizeof(Dataset));
+}
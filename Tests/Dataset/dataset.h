@@ -0,0 +1,103 @@
+/*
+ * dataset.h
+ *
+ * Created: 18. Oct. 2026
+ *  Author: Frank Bjørnø
+ *
+ * Purpose:
+ *      Store generated test data in a small self describing binary file, written through a
+ *      large buffer and read back by mapping the file into memory.
+ *
+ * License:
+ *
+ *          Copyright (C) 2026 Frank Bjørnø
+ *
+ *          1. Permission is hereby granted, free of charge, to any person obtaining a copy
+ *          of this software and associated documentation files (the "Software"), to deal
+ *          in the Software without restriction, including without limitation the rights
+ *          to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ *          of the Software, and to permit persons to whom the Software is furnished to do
+ *          so, subject to the following conditions:
+ *
+ *          2. The above copyright notice and this permission notice shall be included in all
+ *          copies or substantial portions of the Software.
+ *
+ *          3. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *          INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ *          PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *          HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ *          CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ *          OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define DATASET_MAGIC     "RNGDATA1"					//  the first 8 bytes of every file
+#define DATASET_ALIGN     64						//  the payload starts at a multiple of this
+#define DATASET_BUFFER    (1 << 22)					//  bytes collected before each write
+
+
+/*
+ *     The type of the values in a file
+ */
+typedef enum {DS_U8 = 1, DS_U32, DS_I32, DS_F64} DSTYPE;
+
+
+/*
+ *     Header
+ *     The first 64 bytes of a file, little endian. The payload is rows x columns values,
+ *     one row after the other, starting at _offset.
+ */
+typedef struct
+{
+	char     _magic[8];						//  DATASET_MAGIC
+	uint32_t _type;							//  DSTYPE of the values
+	uint32_t _columns;						//  values in a row
+	uint64_t _rows;							//  number of rows
+	uint64_t _offset;						//  start of the payload, a multiple of DATASET_ALIGN
+	uint32_t _seed;							//  seed the data was generated from, 0 if none
+	uint32_t _a, _c, _m;						//  parameters of the generator
+	uint8_t  _reserved[16];						//  0
+} DatasetHeader;
+
+
+/*
+ *     Writer
+ */
+typedef struct
+{
+	FILE          *_fp;
+	DatasetHeader  _header;
+	size_t         _size;						//  bytes in a value
+	size_t         _used;						//  bytes waiting in _buffer
+	unsigned char *_buffer;
+} DatasetWriter;
+
+
+/*
+ *     Dataset
+ *     A file mapped into memory. _data points to the payload inside the mapping, nothing is
+ *     copied.
+ */
+typedef struct
+{
+	DatasetHeader  _header;
+	const void    *_data;						//  the rows x columns values
+	void          *_map;						//  start of the mapping
+	size_t         _length;						//  bytes in the mapping
+	void          *_handle;						//  the file mapping object on Windows
+} Dataset;
+
+size_t dataset_size(DSTYPE type);
+
+int  dataset_create(DatasetWriter *w, const char *name, DSTYPE type, unsigned int columns, unsigned int seed);
+int  dataset_write(DatasetWriter *w, const void *values, size_t rows);
+int  dataset_close(DatasetWriter *w);
+
+int  dataset_open(Dataset *d, const char *name);
+void dataset_free(Dataset *d);
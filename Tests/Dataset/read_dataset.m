@@ -0,0 +1,65 @@
+%
+%  read_dataset.m
+% 
+%  Created: 18. Oct. 2026
+%   Author: Frank Bjørnø
+% 
+%  Purpose: Read a file written by dataset.c. The file is mapped into memory with memmapfile,
+%           so the values are not parsed, and DATA is a columns x rows matrix of doubles:
+%           column n of DATA is row n of the file.
+%           INFO holds the header: type, columns, rows, seed and the parameters a, c and m of
+%           the generator.
+% 
+%  License:
+%  
+%           Copyright (C) 2026 Frank Bjørnø
+% 
+%           1. Permission is hereby granted, free of charge, to any person obtaining a copy 
+%           of this software and associated documentation files (the "Software"), to deal 
+%           in the Software without restriction, including without limitation the rights 
+%           to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies 
+%           of the Software, and to permit persons to whom the Software is furnished to do 
+%           so, subject to the following conditions:
+%         
+%           2. The above copyright notice and this permission notice shall be included in all 
+%           copies or substantial portions of the Software.
+% 
+%           3. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, 
+%           INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A 
+%           PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT 
+%           HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF 
+%           CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE 
+%           OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+%
+
+function [DATA, INFO] = read_dataset(name)
+
+types = {'uint8', 'uint32', 'int32', 'double'};			%  DS_U8, DS_U32, DS_I32, DS_F64
+
+%  --------------------------    Read Header    --------------------------
+
+fileID = fopen(name, 'r', 'ieee-le');
+if (fileID == -1)
+    error('Could not open %s.', name);
+end
+
+magic          = fread(fileID, [1 8], '*char');
+INFO.type      = fread(fileID, 1, 'uint32');
+INFO.columns   = fread(fileID, 1, 'uint32');
+INFO.rows      = fread(fileID, 1, 'uint64');
+offset         = fread(fileID, 1, 'uint64');
+INFO.seed      = fread(fileID, 1, 'uint32');
+INFO.a         = fread(fileID, 1, 'uint32');
+INFO.c         = fread(fileID, 1, 'uint32');
+INFO.m         = fread(fileID, 1, 'uint32');
+fclose(fileID);
+
+if (~strcmp(magic, 'RNGDATA1') || INFO.type < 1 || INFO.type > 4)
+    error('%s is not a dataset.', name);
+end
+
+%  ---------------------------    Map Data    ----------------------------
+
+map  = memmapfile(name, 'Offset', offset, 'Format', {types{INFO.type}, [INFO.columns INFO.rows], 'x'}, 'Repeat', 1);
+DATA = double(map.Data.x);
+end
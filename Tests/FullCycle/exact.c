@@ -0,0 +1,293 @@
+/*
+ * exact.c
+ *
+ * Created: 18. Oct. 2026
+ *  Author: Frank Bjørnø
+ *
+ * Purpose:
+ *      Compute exact properties of the whole period of the random number generator instead
+ *      of estimating them from samples: the frequency of each output bit, the autocorrelation
+ *      with lag 1 to MAXLAG and the number of binary runs in 16 bit sequences, as counted by
+ *      the program chiruns.c.
+ *
+ * Compilation:
+ *     From the command line with Microsoft (R) C/C++ Optimizing Compiler.
+ *
+ *      1. Compile and link the program using the command
+ *         cl /O2 /openmp /arch:AVX2 exact.c fullcycle.c generator.c statistics.c
+ *
+ * License:
+ *
+ *          Copyright (C) 2026 Frank Bjørnø
+ *
+ *          1. Permission is hereby granted, free of charge, to any person obtaining a copy
+ *          of this software and associated documentation files (the "Software"), to deal
+ *          in the Software without restriction, including without limitation the rights
+ *          to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ *          of the Software, and to permit persons to whom the Software is furnished to do
+ *          so, subject to the following conditions:
+ *
+ *          2. The above copyright notice and this permission notice shall be included in all
+ *          copies or substantial portions of the Software.
+ *
+ *          3. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *          INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ *          PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *          HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ *          CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ *          OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <stdio.h>
+#include <time.h>
+
+#include "generator.h"
+#include "fullcycle.h"
+#include "statistics.h"
+
+#define BITS          31						//  bits in a raw number
+#define MAXLAG        20
+#define SEQUENCE      16						//  numbers in a binary runs sequence
+#define SEED     0x13b3e
+
+
+
+/***************************************************************************************************
+ *                                                                                                 *
+ *                                         Bit frequencies                                         *
+ *                                                                                                 *
+ ***************************************************************************************************/
+
+typedef struct
+{
+	unsigned long long _ones[BITS];					//  number of times each bit is set
+} BitCount;
+
+static void bits_init(void *p, const void *ctx)
+{
+	(void)ctx;
+	for (int b = 0; b < BITS; b++) ((BitCount *)p) -> _ones[b] = 0;
+}
+
+static void bits_block(void *p, const unsigned int *x, size_t n, const void *ctx)
+{
+	(void)ctx;
+	BitCount *bc = (BitCount *)p;
+	for (int b = 0; b < BITS; b++)
+	{
+		unsigned int ones = 0;
+		for (size_t i = 0; i < n; i++) ones += (x[i] >> b) & 1;
+		bc -> _ones[b] += ones;
+	}
+}
+
+static void bits_merge(void *into, const void *from, const void *ctx)
+{
+	(void)ctx;
+	for (int b = 0; b < BITS; b++) ((BitCount *)into) -> _ones[b] += ((const BitCount *)from) -> _ones[b];
+}
+
+
+
+/***************************************************************************************************
+ *                                                                                                 *
+ *                                         Autocorrelation                                         *
+ *                                                                                                 *
+ ***************************************************************************************************/
+
+/*
+ *     The sums of squares and products outgrow 64 bits over the whole cycle, so they
+ *     are kept as 128 bit numbers in two 64 bit halves.
+ */
+typedef struct
+{
+	unsigned long long _lo, _hi;
+} Sum128;
+
+typedef struct
+{
+	unsigned long long _sum;					//  sum of Xn
+	Sum128             _squares;					//  sum of Xn * Xn
+	Sum128             _products[MAXLAG];				//  sum of Xn * Xn+k, k = 1, 2, ..., MAXLAG
+} LagSums;
+
+static void add128(Sum128 *s, unsigned long long x)
+{
+	s -> _lo += x;
+	s -> _hi += (s -> _lo < x);
+}
+
+static double value128(const Sum128 *s)
+{
+	return s -> _hi * 18446744073709551616.0 + s -> _lo;
+}
+
+static void lag_init(void *p, const void *ctx)
+{
+	(void)ctx;
+	LagSums *ls = (LagSums *)p;
+	ls -> _sum = 0;
+	ls -> _squares._lo = ls -> _squares._hi = 0;
+	for (int k = 0; k < MAXLAG; k++) ls -> _products[k]._lo = ls -> _products[k]._hi = 0;
+}
+
+/*
+ *     The block is followed by MAXLAG numbers, so the products Xn * Xn+k that straddle the
+ *     end of the block are counted here and only here.
+ *
+ *     Note:  Within a block, the upper and lower 32 bits of the products are summed in
+ *            separate 64 bit variables, which can not overflow, and added to the 128 bit
+ *            sums once per block. This keeps the inner loop free of carries.
+ */
+static void lag_block(void *p, const unsigned int *x, size_t n, const void *ctx)
+{
+	(void)ctx;
+	LagSums *ls = (LagSums *)p;
+
+	for (size_t i = 0; i < n; i++) ls -> _sum += x[i];
+
+	for (int k = 0; k <= MAXLAG; k++)				//  k = 0 gives the squares
+	{
+		unsigned long long hi = 0, lo = 0, product;
+		Sum128 *s = (k == 0) ? &ls -> _squares : &ls -> _products[k - 1];
+
+		for (size_t i = 0; i < n; i++)
+		{
+			product = (unsigned long long)x[i] * x[i + k];
+			hi += product >> 32;
+			lo += product & 0xffffffff;
+		}
+		add128(s, hi << 32);
+		s -> _hi += hi >> 32;
+		add128(s, lo);
+	}
+}
+
+static void lag_merge(void *into, const void *from, const void *ctx)
+{
+	(void)ctx;
+	LagSums *a = (LagSums *)into;
+	const LagSums *b = (const LagSums *)from;
+
+	a -> _sum += b -> _sum;
+	add128(&a -> _squares, b -> _squares._lo);
+	a -> _squares._hi += b -> _squares._hi;
+	for (int k = 0; k < MAXLAG; k++)
+	{
+		add128(&a -> _products[k], b -> _products[k]._lo);
+		a -> _products[k]._hi += b -> _products[k]._hi;
+	}
+}
+
+
+
+/***************************************************************************************************
+ *                                                                                                 *
+ *                                          Binary runs                                            *
+ *                                                                                                 *
+ ***************************************************************************************************/
+
+typedef struct
+{
+	unsigned long long _count[SEQUENCE];				//  number of sequences with 1, 2, ..., 16 runs
+} RunsCount;
+
+static void runs_init(void *p, const void *ctx)
+{
+	(void)ctx;
+	for (int c = 0; c < SEQUENCE; c++) ((RunsCount *)p) -> _count[c] = 0;
+}
+
+/*
+ *     Code 16 numbers as in get_sequence() in chiruns.c, i.e. a 1 for a number above the mean
+ *     and a 0 for a number below, and count the runs. SEQUENCE divides FULLCYCLE_BLOCK, so
+ *     no sequence is split between two blocks.
+ */
+static void runs_block(void *p, const unsigned int *x, size_t n, const void *ctx)
+{
+	(void)ctx;
+	RunsCount *rc = (RunsCount *)p;
+	const double mean = GENERATOR_M / 2.0;
+
+	for (size_t i = 0; i < n; i += SEQUENCE)
+	{
+		unsigned int sequence = 0, changes;
+		for (int c = 0; c < SEQUENCE; c++) sequence |= (x[i + c] > mean) << c;
+
+		changes = (sequence ^ (sequence >> 1)) & 0x7fff;		//  bit c is set if bit c and c + 1 differ
+		int runs = 1;
+		for (; changes; changes &= changes - 1) runs++;
+		rc -> _count[runs - 1]++;
+	}
+}
+
+static void runs_merge(void *into, const void *from, const void *ctx)
+{
+	(void)ctx;
+	for (int c = 0; c < SEQUENCE; c++) ((RunsCount *)into) -> _count[c] += ((const RunsCount *)from) -> _count[c];
+}
+
+
+
+int main(void)
+{
+	BitCount  bits;
+	LagSums   lags;
+	RunsCount runs;
+
+	Reducer reducers[3] =
+	{
+		{sizeof(BitCount), 0,      bits_init, bits_block, bits_merge, NULL},
+		{sizeof(LagSums),  MAXLAG, lag_init,  lag_block,  lag_merge,  NULL},
+		{sizeof(RunsCount), 0,     runs_init, runs_block, runs_merge, NULL}
+	};
+	void *results[3] = {&bits, &lags, &runs};
+
+	clock_t t = clock();
+	if (fullcycle_run(reducers, results, 3, SEED))
+	{
+		puts("Error: Could not allocate memory.");
+		return 1;
+	}
+	t = clock() - t;
+
+	const double N = (double)FULLCYCLE_LENGTH;
+
+	printf("\n\n          Exact properties of the full cycle of %llu numbers  (%.2f s cpu)\n\n", FULLCYCLE_LENGTH, (double)t / CLOCKS_PER_SEC);
+
+		//  bit frequencies
+	printf("    %3s   %12s   %12s   %10s\n", "Bit", "ones", "expected", "residual");
+	puts("    -----------------------------------------------");
+	for (int b = 0; b < BITS; b++)
+	{
+		printf("    %3d   %12llu   %12.0f   %10.0f\n", b, bits._ones[b], N / 2, bits._ones[b] - N / 2);
+	}
+	puts("    -----------------------------------------------\n");
+
+		//  autocorrelation
+	double mean = lags._sum / N;
+	double var  = value128(&lags._squares) / N - mean * mean;
+
+	printf("    %3s   %14s\n", "Lag", "Coeff.");
+	puts("    ---------------------");
+	for (int k = 0; k < MAXLAG; k++)
+	{
+		printf("    %3d   %14.6e\n", k + 1, (value128(&lags._products[k]) / N - mean * mean) / var);
+	}
+	puts("    ---------------------");
+
+		//  binary runs, the expected number of sequences with r runs is 2 * C(15, r - 1) / 2^16 of the sequences
+	double observed[SEQUENCE], expected[SEQUENCE], binomial = 1.0;
+	char  *labels[SEQUENCE + 1] = {"runs", " 1", " 2", " 3", " 4", " 5", " 6", " 7", " 8", " 9", "10", "11", "12", "13", "14", "15", "16"};
+
+	for (int r = 0; r < SEQUENCE; r++)
+	{
+		observed[r] = (double)runs._count[r];
+		expected[r] = 2.0 * binomial * (N / SEQUENCE) / 65536.0;
+		binomial = binomial * (SEQUENCE - 1 - r) / (r + 1);
+	}
+	statistics_csgof(observed, expected, SEQUENCE, labels, 0.1);
+
+	return 0;
+}
@@ -0,0 +1,132 @@
+/*
+ * fullcycle.c
+ *
+ * Created: 18. Oct. 2026
+ *  Author: Frank Bjørnø
+ *
+ * Purpose:
+ *      Run reducers over the whole period of the random number generator, split into
+ *      chunks that are processed in parallel.
+ *
+ * License:
+ *
+ *          Copyright (C) 2026 Frank Bjørnø
+ *
+ *          1. Permission is hereby granted, free of charge, to any person obtaining a copy
+ *          of this software and associated documentation files (the "Software"), to deal
+ *          in the Software without restriction, including without limitation the rights
+ *          to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ *          of the Software, and to permit persons to whom the Software is furnished to do
+ *          so, subject to the following conditions:
+ *
+ *          2. The above copyright notice and this permission notice shall be included in all
+ *          copies or substantial portions of the Software.
+ *
+ *          3. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *          INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ *          PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *          HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ *          CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ *          OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "generator.h"
+#include "fullcycle.h"
+
+#define _CHUNK    (FULLCYCLE_LENGTH / FULLCYCLE_CHUNKS)		//  values in one chunk
+
+
+
+/*
+ *     Run a set of reducers over the whole cycle of the generator.
+ *
+ *     \param *reducers  Pointer to an array of reducers.
+ *     \param **results  Pointer to an array of pointers to memory receiving the results.
+ *                       results[i] must point to at least reducers[i]._size bytes.
+ *     \param  count     Number of reducers.
+ *     \param  seed      Seed of the generator. The cycle starts with the first number
+ *                       generated from this seed.
+ *
+ *     \return           0 on success, 1 if memory could not be allocated.
+ *
+ *     Note:  The cycle is split into FULLCYCLE_CHUNKS chunks, and each thread jumps ahead
+ *            to the start of a chunk and generates it with the bulk kernel, FULLCYCLE_BLOCK
+ *            numbers at a time. Blocks start at multiples of FULLCYCLE_BLOCK from the start
+ *            of the cycle, so a reducer that works on groups of numbers whose size divides
+ *            FULLCYCLE_BLOCK never sees a group split between two blocks.
+ *
+ *     Note:  Every chunk has its own partial result and they are merged in the order of the
+ *            chunks, so the results do not depend on the number of threads.
+ */
+int fullcycle_run(const Reducer *reducers, void **results, int count, unsigned int seed)
+{
+	size_t window = 0;
+	int    error  = 0;
+
+	for (int r = 0; r < count; r++) if (reducers[r]._window > window) window = reducers[r]._window;
+
+		//  allocate memory for the partial results of each chunk
+	char **partials = (char **)calloc(count, sizeof(char *));
+	if (partials == NULL) return 1;
+	for (int r = 0; r < count; r++)
+	{
+		partials[r] = (char *)malloc(FULLCYCLE_CHUNKS * reducers[r]._size);
+		if (partials[r] == NULL) error = 1;
+	}
+
+		//  error is shared by the threads, so it is only read and written atomically
+#pragma omp parallel for schedule(dynamic)
+	for (int k = 0; k < FULLCYCLE_CHUNKS; k++)
+	{
+		int stop;
+#pragma omp atomic read
+		stop = error;
+		if (stop) continue;
+
+		unsigned int *x = (unsigned int *)malloc((FULLCYCLE_BLOCK + window) * sizeof(unsigned int));
+		if (x == NULL)
+		{
+#pragma omp atomic write
+			error = 1;
+			continue;
+		}
+
+		Generator g;
+		generator_init(&g, seed);
+		generator_jump(&g, (unsigned long long)k * _CHUNK);
+
+		for (int r = 0; r < count; r++) reducers[r]._init(partials[r] + k * reducers[r]._size, reducers[r]._ctx);
+
+			//  x holds a block followed by the window of numbers after it. The window of one
+			//  block becomes the start of the next.
+		generator_fill(&g, x + FULLCYCLE_BLOCK, window);
+		for (unsigned long long n = 0; n < _CHUNK; n += FULLCYCLE_BLOCK)
+		{
+			memmove(x, x + FULLCYCLE_BLOCK, window * sizeof(unsigned int));
+			generator_fill(&g, x + window, FULLCYCLE_BLOCK);
+			for (int r = 0; r < count; r++)
+			{
+				reducers[r]._block(partials[r] + k * reducers[r]._size, x, FULLCYCLE_BLOCK, reducers[r]._ctx);
+			}
+		}
+		free(x);
+	}
+
+		//  merge the partial results in the order of the chunks
+	if (!error)
+	{
+		for (int r = 0; r < count; r++)
+		{
+			reducers[r]._init(results[r], reducers[r]._ctx);
+			for (int k = 0; k < FULLCYCLE_CHUNKS; k++) reducers[r]._merge(results[r], partials[r] + k * reducers[r]._size, reducers[r]._ctx);
+		}
+	}
+
+	for (int r = 0; r < count; r++) free(partials[r]);
+	free(partials);
+	return error;
+}
@@ -0,0 +1,61 @@
+/*
+ * fullcycle.h
+ *
+ * Created: 18. Oct. 2026
+ *  Author: Frank Bjørnø
+ *
+ * Purpose:
+ *      Run reducers over the whole period of the random number generator, split into
+ *      chunks that are processed in parallel.
+ *
+ * License:
+ *
+ *          Copyright (C) 2026 Frank Bjørnø
+ *
+ *          1. Permission is hereby granted, free of charge, to any person obtaining a copy
+ *          of this software and associated documentation files (the "Software"), to deal
+ *          in the Software without restriction, including without limitation the rights
+ *          to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ *          of the Software, and to permit persons to whom the Software is furnished to do
+ *          so, subject to the following conditions:
+ *
+ *          2. The above copyright notice and this permission notice shall be included in all
+ *          copies or substantial portions of the Software.
+ *
+ *          3. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *          INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ *          PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *          HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ *          CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ *          OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <stddef.h>
+
+#define FULLCYCLE_LENGTH     (1ULL << 31)				//  the period of the generator
+#define FULLCYCLE_CHUNKS     256					//  number of jump-ahead chunks
+#define FULLCYCLE_BLOCK      4096					//  values passed to a reducer at a time
+
+
+/*
+ *     Reducer
+ *     A reducer computes a partial result over the chunks of the cycle it is given, and the
+ *     partial results of all chunks are merged into one. A reducer that looks at windows of
+ *     consecutive values, e.g. pairs (Xn, Xn+k), sets _window to the number of values it needs
+ *     to see beyond the end of a block, and the framework supplies them, also across chunk
+ *     boundaries and across the end of the cycle.
+ */
+typedef struct
+{
+	size_t  _size;							//  size in bytes of a partial result
+	size_t  _window;						//  values needed beyond the end of a block
+	void  (*_init)(void *partial, const void *ctx);		//  set a partial result to the empty result
+	void  (*_block)(void *partial, const unsigned int *x, size_t n, const void *ctx);
+	void  (*_merge)(void *into, const void *from, const void *ctx);
+	const void *_ctx;						//  parameters passed to the functions, may be NULL
+} Reducer;
+
+int fullcycle_run(const Reducer *reducers, void **results, int count, unsigned int seed);
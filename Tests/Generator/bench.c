@@ -0,0 +1,125 @@
+/*
+ * bench.c
+ *
+ * Created: 18. Oct. 2026
+ *  Author: Frank Bjørnø
+ *
+ * Purpose:
+ *      Compare the speed of taking numbers one at a time from a view to the speed of
+ *      the hand written bulk loop the view is built on.
+ *
+ * Compilation:
+ *     From the command line with Microsoft (R) C/C++ Optimizing Compiler.
+ *
+ *      1. Compile and link the program using the command
+ *         cl /O2 /arch:AVX2 bench.c generator.c
+ *
+ * License:
+ *
+ *          Copyright (C) 2026 Frank Bjørnø
+ *
+ *          1. Permission is hereby granted, free of charge, to any person obtaining a copy
+ *          of this software and associated documentation files (the "Software"), to deal
+ *          in the Software without restriction, including without limitation the rights
+ *          to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ *          of the Software, and to permit persons to whom the Software is furnished to do
+ *          so, subject to the following conditions:
+ *
+ *          2. The above copyright notice and this permission notice shall be included in all
+ *          copies or substantial portions of the Software.
+ *
+ *          3. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *          INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ *          PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *          HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ *          CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ *          OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <stdio.h>
+#include <time.h>
+
+#include "generator.h"
+
+#define N       (1 << 28)						//  numbers taken in each run
+#define SEED    0x13b3e
+
+
+
+/*
+ *     Print one line of the table, the time of the view relative to the bulk loop.
+ */
+static void report(const char *name, clock_t bulk, clock_t view)
+{
+	double tb = (double)bulk / CLOCKS_PER_SEC;
+	double tv = (double)view / CLOCKS_PER_SEC;
+	printf("    %-8s %10.3f s %10.3f s %9.1f %%\n", name, tb, tv, 100.0 * (tv - tb) / tb);
+}
+
+
+
+int main(void)
+{
+	unsigned int raw[GENERATOR_BLOCK];
+	double       flt[GENERATOR_BLOCK];
+	int          num[GENERATOR_BLOCK];
+
+	Generator g;
+	View      v;
+	clock_t   t0, t1, t2;
+
+		//  the sums keep the compiler from removing the loops
+	unsigned long long sr = 0, vr = 0, si = 0, vi = 0;
+	double sf = 0.0, vf = 0.0;
+
+	printf("\n\n    %-8s %12s %12s %11s\n", "output", "bulk loop", "view", "overhead");
+	puts("    ---------------------------------------------");
+
+		//  raw numbers
+	generator_init(&g, SEED);
+	t0 = clock();
+	for (int n = 0; n < N; n += GENERATOR_BLOCK)
+	{
+		generator_fill(&g, raw, GENERATOR_BLOCK);
+		for (int c = 0; c < GENERATOR_BLOCK; c++) sr += raw[c];
+	}
+	t1 = clock();
+	view_init(&v, GV_RAW, SEED);
+	for (int n = 0; n < N; n++) vr += view_raw(&v);
+	t2 = clock();
+	report("raw", t1 - t0, t2 - t1);
+
+		//  numbers in the interval [0.0, 1.0]
+	generator_init(&g, SEED);
+	t0 = clock();
+	for (int n = 0; n < N; n += GENERATOR_BLOCK)
+	{
+		generator_fill_flt(&g, flt, GENERATOR_BLOCK);
+		for (int c = 0; c < GENERATOR_BLOCK; c++) sf += flt[c];
+	}
+	t1 = clock();
+	view_init(&v, GV_FLT, SEED);
+	for (int n = 0; n < N; n++) vf += view_flt(&v);
+	t2 = clock();
+	report("float", t1 - t0, t2 - t1);
+
+		//  integers in the interval [1, 6]
+	generator_init(&g, SEED);
+	t0 = clock();
+	for (int n = 0; n < N; n += GENERATOR_BLOCK)
+	{
+		generator_fill_int(&g, num, GENERATOR_BLOCK, 1, 6);
+		for (int c = 0; c < GENERATOR_BLOCK; c++) si += num[c];
+	}
+	t1 = clock();
+	view_init_int(&v, SEED, 1, 6);
+	for (int n = 0; n < N; n++) vi += view_int(&v);
+	t2 = clock();
+	report("int", t1 - t0, t2 - t1);
+
+	puts("    ---------------------------------------------");
+	printf("    Same numbers:  %s\n\n", (sr == vr && sf == vf && si == vi) ? "YES" : "NO");
+
+	return 0;
+}
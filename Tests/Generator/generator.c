@@ -0,0 +1,341 @@
+/*
+ * generator.c
+ *
+ * Created: 18. Oct. 2026
+ *  Author: Frank Bjørnø
+ *
+ * Purpose:
+ *      A re-entrant C implementation of the random number generator in rng.asm, with
+ *      bulk kernels that fill whole buffers and block buffered views for element wise
+ *      access.
+ *
+ * License:
+ *
+ *          Copyright (C) 2026 Frank Bjørnø
+ *
+ *          1. Permission is hereby granted, free of charge, to any person obtaining a copy
+ *          of this software and associated documentation files (the "Software"), to deal
+ *          in the Software without restriction, including without limitation the rights
+ *          to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ *          of the Software, and to permit persons to whom the Software is furnished to do
+ *          so, subject to the following conditions:
+ *
+ *          2. The above copyright notice and this permission notice shall be included in all
+ *          copies or substantial portions of the Software.
+ *
+ *          3. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *          INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ *          PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *          HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ *          CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ *          OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#include "generator.h"
+
+#define _LANES    8							//  number of seeds advanced in parallel by the bulk kernel
+
+
+
+/*
+ *     Advance a seed one step, Xn+1 = (aXn + c) mod m.
+ *
+ *     Note:  m is 2^31, so the modulus operation is an AND with __m = 2^31 - 1,
+ *            exactly as in the __generate procedure in rng.asm.
+ */
+static unsigned int _step(unsigned int x)
+{
+	return (GENERATOR_A * x + GENERATOR_C) & GENERATOR_M;
+}
+
+
+
+/*
+ *     Shuffle the bits of a seed the same way the __generate procedure in rng.asm does.
+ *     The procedure rotates bits 30, 29 and 28 of the seed into bits 0, 1 and 2 of the
+ *     result, and the remaining bits are shifted three places to the left.
+ */
+static unsigned int _hash(unsigned int x)
+{
+	return ((x << 3) & 0x7ffffff8) | ((x >> 26) & 0x04) | ((x >> 28) & 0x02) | ((x >> 30) & 0x01);
+}
+
+
+
+/***************************************************************************************************
+ *                                                                                                 *
+ *                                           Generator                                             *
+ *                                                                                                 *
+ ***************************************************************************************************/
+
+/*
+ *     Shuffle the bits of a seed the way rnd() in rng.asm does before returning it.
+ *
+ *     \param  seed  A seed, Xn.
+ *
+ *     \return       The raw random number corresponding to the seed.
+ *
+ *     Note:  Lets code that steps other linear congruential generators, e.g. when comparing
+ *            multipliers, produce numbers the same way as rng.asm.
+ */
+unsigned int generator_hash(unsigned int seed)
+{
+	return _hash(seed);
+}
+
+
+
+/*
+ *     Set the seed of a generator.
+ *
+ *     \param *g     Pointer to the generator.
+ *     \param  seed  The new seed.
+ *
+ *     Note:  As with set_seed in rng.asm, the seed may be larger than __m. Only the first
+ *            number generated is affected.
+ */
+void generator_init(Generator *g, unsigned int seed)
+{
+	g -> _seed = seed;
+}
+
+
+
+/*
+ *     Generate a raw random number in the interval [0, __m].
+ */
+unsigned int generator_rnd(Generator *g)
+{
+	return _hash(g -> _seed = _step(g -> _seed));
+}
+
+
+
+/*
+ *     Generate a random number in the interval [0.0, 1.0].
+ */
+double generator_rndflt(Generator *g)
+{
+	return generator_rnd(g) / (double)GENERATOR_M;
+}
+
+
+
+/*
+ *     Generate a random integer in the interval [A, B].
+ *
+ *     Note:  No error checking of any kind will be performed. If A < B does not hold,
+ *            behaviour is undefined. The number is scaled the same way as rndint in rng.asm.
+ */
+int generator_rndint(Generator *g, int A, int B)
+{
+	return (int)(generator_rnd(g) % (unsigned int)(B - A + 1)) + A;
+}
+
+
+
+/*
+ *     Compute the coefficients of n steps of a linear congruential generator with
+ *     multiplier a, increment c and modulus 2^31, so that Xk+n = (A*Xk + C) mod 2^31.
+ *
+ *     \param  a     Multiplier of one step.
+ *     \param  c     Increment of one step.
+ *     \param  n     Number of steps.
+ *     \param *A     Pointer to variable that will receive the multiplier of n steps.
+ *     \param *C     Pointer to variable that will receive the increment of n steps.
+ *
+ *     Note:  The composition of two steps (a1, c1) and (a2, c2) is (a1*a2, a2*c1 + c2), so
+ *            the coefficients are found with O(log n) squarings. The parameters need not
+ *            be those of rng.asm, which lets the period analysis examine other choices.
+ */
+void generator_affine(unsigned int a, unsigned int c, unsigned long long n, unsigned int *A, unsigned int *C)
+{
+	unsigned int ra = 1, rc = 0;					//  accumulated coefficients
+
+	for (; n > 0; n >>= 1)						//  a and c are the coefficients of 2^k steps
+	{
+		if (n & 1) ra *= a, rc = rc * a + c;
+		c *= a + 1;
+		a *= a;
+	}
+	*A = ra & GENERATOR_M;
+	*C = rc & GENERATOR_M;
+}
+
+
+
+/*
+ *     Advance a generator n steps without generating the numbers in between.
+ *
+ *     \param *g     Pointer to the generator.
+ *     \param  n     Number of steps.
+ *
+ *     Note:  The period of the generator is 2^31, so n = 2^31 leaves the seed unchanged,
+ *            apart from clearing bit 31 of a seed set with generator_init.
+ */
+void generator_jump(Generator *g, unsigned long long n)
+{
+	unsigned int A, C;
+	generator_affine(GENERATOR_A, GENERATOR_C, n, &A, &C);
+	g -> _seed = (A * g -> _seed + C) & GENERATOR_M;
+}
+
+
+
+/*
+ *     Fill a buffer with raw random numbers. This produces exactly the same numbers as
+ *     n calls to generator_rnd.
+ *
+ *     \param *g       Pointer to the generator.
+ *     \param *buffer  Pointer to the buffer receiving the numbers.
+ *     \param  n       Number of values to generate.
+ *
+ *     Note:  With AVX2, eight consecutive seeds are kept in one register and each of them
+ *            is advanced eight steps at a time.
+ */
+void generator_fill(Generator *g, unsigned int *buffer, size_t n)
+{
+	unsigned int x = g -> _seed;
+	size_t i = 0;
+
+#ifdef __AVX2__
+	if (n >= 2 * _LANES)
+	{
+		unsigned int A, C, lanes[_LANES];
+		generator_affine(GENERATOR_A, GENERATOR_C, _LANES, &A, &C);
+		for (int c = 0; c < _LANES; c++) lanes[c] = x = _step(x);
+
+		const __m256i a = _mm256_set1_epi32(A);
+		const __m256i k = _mm256_set1_epi32(C);
+		const __m256i m = _mm256_set1_epi32(GENERATOR_M);
+		__m256i s = _mm256_loadu_si256((const __m256i *)lanes);
+		__m256i h;
+
+		for (;;)
+		{
+				//  hash, see _hash
+			h = _mm256_and_si256(_mm256_slli_epi32(s, 3), _mm256_set1_epi32(0x7ffffff8));
+			h = _mm256_or_si256(h, _mm256_and_si256(_mm256_srli_epi32(s, 26), _mm256_set1_epi32(0x04)));
+			h = _mm256_or_si256(h, _mm256_and_si256(_mm256_srli_epi32(s, 28), _mm256_set1_epi32(0x02)));
+			h = _mm256_or_si256(h, _mm256_srli_epi32(s, 30));
+			_mm256_storeu_si256((__m256i *)(buffer + i), h);
+
+			if ((i += _LANES) + _LANES > n) break;
+			s = _mm256_and_si256(_mm256_add_epi32(_mm256_mullo_epi32(s, a), k), m);
+		}
+		_mm256_storeu_si256((__m256i *)lanes, s);
+		x = lanes[_LANES - 1];						//  seed of the last number stored
+	}
+#endif
+
+	for (; i < n; i++) buffer[i] = _hash(x = _step(x));
+	g -> _seed = x;
+}
+
+
+
+/*
+ *     Fill a buffer with random numbers in the interval [0.0, 1.0]. This produces exactly
+ *     the same numbers as n calls to generator_rndflt.
+ */
+void generator_fill_flt(Generator *g, double *buffer, size_t n)
+{
+	unsigned int raw[GENERATOR_BLOCK];
+
+	while (n > 0)
+	{
+		size_t k = (n < GENERATOR_BLOCK) ? n : GENERATOR_BLOCK;
+		generator_fill(g, raw, k);
+
+		size_t i = 0;
+#ifdef __AVX2__
+		const __m256d d = _mm256_set1_pd((double)GENERATOR_M);
+		for (; i + 4 <= k; i += 4)
+		{
+			__m256d v = _mm256_cvtepi32_pd(_mm_loadu_si128((const __m128i *)(raw + i)));
+			_mm256_storeu_pd(buffer + i, _mm256_div_pd(v, d));
+		}
+#endif
+		for (; i < k; i++) buffer[i] = raw[i] / (double)GENERATOR_M;
+
+		buffer += k;
+		n -= k;
+	}
+}
+
+
+
+/*
+ *     Fill a buffer with random integers in the interval [A, B]. This produces exactly
+ *     the same numbers as n calls to generator_rndint.
+ */
+void generator_fill_int(Generator *g, int *buffer, size_t n, int A, int B)
+{
+	const unsigned int w = (unsigned int)(B - A + 1);
+
+		//  the raw numbers are generated in place, then scaled
+	generator_fill(g, (unsigned int *)buffer, n);
+	for (size_t i = 0; i < n; i++) buffer[i] = (int)(((unsigned int *)buffer)[i] % w) + A;
+}
+
+
+
+/***************************************************************************************************
+ *                                                                                                 *
+ *                                             View                                                *
+ *                                                                                                 *
+ ***************************************************************************************************/
+
+/*
+ *     Prepare a view of raw numbers or of numbers in the interval [0.0, 1.0].
+ *
+ *     \param *v     Pointer to the view.
+ *     \param  type  GV_RAW or GV_FLT.
+ *     \param  seed  The seed of the stream.
+ *
+ *     Example:  View v;
+ *               view_init(&v, GV_FLT, 1234);
+ *               for (int c = 0; c < n; c++) sum += view_flt(&v);
+ */
+void view_init(View *v, VIEWTYPE type, unsigned int seed)
+{
+	generator_init(&v -> _gen, seed);
+	v -> _type = type;
+	v -> _min = 0, v -> _max = GENERATOR_M;
+	v -> _pos = GENERATOR_BLOCK;					//  the first access fills the block
+}
+
+
+
+/*
+ *     Prepare a view of integers in the interval [A, B].
+ */
+void view_init_int(View *v, unsigned int seed, int A, int B)
+{
+	view_init(v, GV_INT, seed);
+	v -> _min = A, v -> _max = B;
+}
+
+
+
+/*
+ *     Fill the block of a view with the bulk kernel matching its type.
+ *
+ *     Note:  The generator of the view is always one block ahead of the values taken
+ *            from the view.
+ */
+void view_refill(View *v)
+{
+	switch(v -> _type)
+	{
+		case GV_FLT: generator_fill_flt(&v -> _gen, v -> _block._flt, GENERATOR_BLOCK); break;
+		case GV_INT: generator_fill_int(&v -> _gen, v -> _block._int, GENERATOR_BLOCK, v -> _min, v -> _max); break;
+		default:     generator_fill(&v -> _gen, v -> _block._raw, GENERATOR_BLOCK); break;
+	}
+	v -> _pos = 0;
+}
@@ -0,0 +1,119 @@
+/*
+ * generator.h
+ *
+ * Created: 18. Oct. 2026
+ *  Author: Frank Bjørnø
+ *
+ * Purpose:
+ *      A re-entrant C implementation of the random number generator in rng.asm, with
+ *      bulk kernels that fill whole buffers and block buffered views for element wise
+ *      access.
+ *
+ * License:
+ *
+ *          Copyright (C) 2026 Frank Bjørnø
+ *
+ *          1. Permission is hereby granted, free of charge, to any person obtaining a copy
+ *          of this software and associated documentation files (the "Software"), to deal
+ *          in the Software without restriction, including without limitation the rights
+ *          to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ *          of the Software, and to permit persons to whom the Software is furnished to do
+ *          so, subject to the following conditions:
+ *
+ *          2. The above copyright notice and this permission notice shall be included in all
+ *          copies or substantial portions of the Software.
+ *
+ *          3. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *          INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ *          PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *          HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ *          CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ *          OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <stddef.h>
+
+/*
+ *     Constants used in the linear congruential function Xn+1 = (aXn + c) mod m.
+ *     These must be kept identical to __a, __c and __m in rng.asm.
+ */
+#define GENERATOR_A          0x47068445
+#define GENERATOR_C          0x001016b5
+#define GENERATOR_M          0x7fffffff
+
+#define GENERATOR_BLOCK      256					//  number of values buffered by a view
+
+
+/*
+ *     Generator
+ *     Holds the seed, Xn, of one stream of numbers. Unlike rng.asm, which keeps a single
+ *     global seed, any number of generators may be used side by side.
+ */
+typedef struct
+{
+	unsigned int _seed;						//  Xn
+} Generator;
+
+void         generator_init(Generator *g, unsigned int seed);	//  Equivalent to set_seed in rng.asm
+unsigned int generator_rnd(Generator *g);				//  Equivalent to rnd in rng.asm
+double       generator_rndflt(Generator *g);				//  Equivalent to rndflt in rng.asm
+ int         generator_rndint(Generator *g, int A, int B);		//  Equivalent to rndint in rng.asm
+
+unsigned int generator_hash(unsigned int seed);				//  The bits of a seed shuffled as by rnd in rng.asm
+
+	//  jump ahead
+void generator_affine(unsigned int a, unsigned int c, unsigned long long n, unsigned int *A, unsigned int *C);
+void generator_jump(Generator *g, unsigned long long n);
+
+	//  bulk kernels
+void generator_fill(Generator *g, unsigned int *buffer, size_t n);
+void generator_fill_flt(Generator *g, double *buffer, size_t n);
+void generator_fill_int(Generator *g, int *buffer, size_t n, int A, int B);
+
+
+
+/*
+ *     View
+ *     A lazy, block buffered sequence of numbers. The view refills its block with one of the
+ *     bulk kernels when it runs dry, so taking the next value is an index test and a load.
+ */
+typedef enum {GV_RAW = 0, GV_FLT, GV_INT} VIEWTYPE;
+
+typedef struct
+{
+	Generator _gen;							//  the stream the view draws from
+	VIEWTYPE  _type;						//  GV_RAW, GV_FLT or GV_INT
+	int       _min, _max;						//  interval [A, B] of a GV_INT view
+	size_t    _pos;							//  index of the next unread value in _block
+	union
+	{
+		unsigned int _raw[GENERATOR_BLOCK];
+		double       _flt[GENERATOR_BLOCK];
+		int          _int[GENERATOR_BLOCK];
+	} _block;
+} View;
+
+void view_init(View *v, VIEWTYPE type, unsigned int seed);		//  Prepare a GV_RAW or GV_FLT view
+void view_init_int(View *v, unsigned int seed, int A, int B);		//  Prepare a GV_INT view of the interval [A, B]
+void view_refill(View *v);						//  Fill the block. Called by the accessors
+
+static __inline unsigned int view_raw(View *v)
+{
+	if (v -> _pos == GENERATOR_BLOCK) view_refill(v);
+	return v -> _block._raw[v -> _pos++];
+}
+
+static __inline double view_flt(View *v)
+{
+	if (v -> _pos == GENERATOR_BLOCK) view_refill(v);
+	return v -> _block._flt[v -> _pos++];
+}
+
+static __inline int view_int(View *v)
+{
+	if (v -> _pos == GENERATOR_BLOCK) view_refill(v);
+	return v -> _block._int[v -> _pos++];
+}
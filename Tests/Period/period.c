@@ -5,16 +5,20 @@
  *  Author: Frank Bjørnø
  *
  * Purpose: 
- *      To count the period length of the random number generator in rng.asm.
+ *      To find the period length of the random number generator in rng.asm, or of any
+ *      other choice of multiplier and increment, and the cycle structure of the state map.
+ *
+ * Usage:
+ *      period [a c [seed]]
+ *
+ *      Without arguments the parameters of rng.asm are analyzed. Numbers may be given
+ *      in decimal or, prefixed with 0x, in hexadecimal.
  *
  * Compilation:
- *     From the command line with Microsoft (R) Macro Assembler and 
- *                                Microsoft (R) C/C++ Optimizing Compiler.
+ *     From the command line with Microsoft (R) C/C++ Optimizing Compiler.
  *
- *      1. Assemble rng.asm without linking using the command
- *         ml /c rng.asm
- *      2. Compile and link the program using the command
- *         cl period.c rng.obj
+ *      1. Compile and link the program using the command
+ *         cl /O2 /openmp period.c generator.c
  *
  * License:
  * 
@@ -41,22 +45,279 @@
 
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "generator.h"
+
+
+#define BITS        31							//  the modulus is 2^BITS
+#define SEGMENTS  1024							//  number of jump-ahead segments in the state walk
+#define LANES        8							//  states compared per step in the state walk
+
+
+
+/*
+ *     Advance a state one step, Xn+1 = (aXn + c) mod 2^31.
+ */
+static unsigned int step(unsigned int a, unsigned int c, unsigned int x)
+{
+	return (a * x + c) & GENERATOR_M;
+}
+
+
+
+/*
+ *     Advance a state n steps.
+ */
+static unsigned int jump(unsigned int a, unsigned int c, unsigned long long n, unsigned int x)
+{
+	unsigned int A, C;
+	generator_affine(a, c, n, &A, &C);
+	return step(A, C, x);
+}
+
+
 
+/*
+ *     Count the states x where f^(2^k)(x) = x, that is, the states whose period divides 2^k.
+ *
+ *     \param  a, c  Multiplier and increment. a must be odd.
+ *     \param  k     Exponent, 0 - 31.
+ *
+ *     \return       Number of solutions of (A - 1)x + C = 0 (mod 2^31) where (A, C) are the
+ *                   coefficients of 2^k steps.
+ *
+ *     Note:  A linear congruence ux = v (mod 2^31) is solvable if and only if v is divisible
+ *            by the largest power of two, 2^t, dividing u, and then it has 2^t solutions.
+ */
+static unsigned long long fixed_points(unsigned int a, unsigned int c, int k)
+{
+	unsigned int A, C;
+	generator_affine(a, c, 1ULL << k, &A, &C);
+
+	unsigned int u = (A - 1) & GENERATOR_M;
+	unsigned int v = (0u - C) & GENERATOR_M;
+	int t = 0;
+
+	if (u == 0) return (v == 0) ? 1ULL << BITS : 0;
+	while (!(u & (1u << t))) t++;
+	return (v & ((1u << t) - 1)) ? 0 : 1ULL << t;
+}
 
-extern         void randomize();
-extern unsigned int rnd();
 
 
-int main(void)
+/*
+ *     Find the period of a state analytically.
+ *
+ *     \return       The smallest 2^k where f^(2^k)(x0) = x0.
+ *
+ *     Note:  When a is odd, the state map is a permutation of the 2^31 states whose order
+ *            divides 2^31, so every cycle has a length that is a power of two.
+ */
+static unsigned long long analytic_period(unsigned int a, unsigned int c, unsigned int x0)
 {
-	randomize();
-	
-	unsigned int      start = rnd();				//  generate one number
-	unsigned long int n     = 1;					//  we have already generated one number
-	
-	while(rnd() != start) n++;		
-		
-	printf("\n\nPeriod length:     HEX %8x\n\n", n);
-	
-	return 0;
+	int k = 0;
+	while (k < BITS && jump(a, c, 1ULL << k, x0) != x0) k++;
+	return 1ULL << k;
+}
+
+
+
+/*
+ *     Find the period of a state by walking the cycle. The 2^31 steps that the longest
+ *     possible cycle would take are split into SEGMENTS segments. Each thread jumps ahead to
+ *     the start of a segment and walks it, looking for the state x0. The first segment that
+ *     meets x0 holds the period.
+ *
+ *     \return       The number of steps until x0 is met again, or 0 if it never is.
+ *
+ *     Note:  The states are compared, not the numbers returned by rnd(). Comparing numbers
+ *            is only safe as long as no number can be returned twice within one period.
+ *
+ *     Note:  LANES consecutive states are advanced LANES steps at a time, so the walk is
+ *            not held up by the latency of one multiplication per step.
+ */
+static unsigned long long walk_period(unsigned int a, unsigned int c, unsigned int x0)
+{
+	const long long size = (1LL << BITS) / SEGMENTS;			//  steps in each segment
+	long long found = 1LL << 62;					//  shared, first step meeting x0, accessed atomically
+
+	unsigned int A, C;
+	generator_affine(a, c, LANES, &A, &C);
+
+#pragma omp parallel for schedule(dynamic)
+	for (int s = 0; s < SEGMENTS; s++)
+	{
+		long long first = s * size + 1;					//  steps first, first + 1, ..., first + size - 1
+		unsigned int x[LANES];
+		long long    last;
+
+#pragma omp atomic read
+		last = found;
+		if (first > last) continue;					//  a previous segment already met x0
+
+		x[0] = jump(a, c, first, x0);
+		for (int j = 1; j < LANES; j++) x[j] = step(a, c, x[j - 1]);
+
+		for (long long n = first; n < first + size; n += LANES)
+		{
+			int hit = 0;
+			for (int j = 0; j < LANES; j++) hit |= (x[j] == x0);
+
+			if (hit)
+			{
+				for (int j = 0; j < LANES; j++) if (x[j] == x0) { hit = j; break; }
+#pragma omp critical
+				if (n + hit < found)
+				{
+#pragma omp atomic write
+					found = n + hit;
+				}
+				break;
+			}
+			for (int j = 0; j < LANES; j++) x[j] = step(A, C, x[j]);
+		}
+	}
+	return (found == 1LL << 62) ? 0 : (unsigned long long)found;
+}
+
+
+
+/*
+ *     Brent's cycle detection algorithm.
+ *
+ *     \param *lambda  Pointer to variable that will receive the length of the cycle.
+ *     \param *mu      Pointer to variable that will receive the number of steps from x0
+ *                     to the first state on the cycle.
+ *
+ *     Note:  Used when a is even. The state map is then not a permutation, and x0 need
+ *            not be on a cycle at all, so the walk above would never meet it again.
+ */
+static void brent(unsigned int a, unsigned int c, unsigned int x0, unsigned long long *lambda, unsigned long long *mu)
+{
+	unsigned long long power = 1, lam = 1, m = 0;
+	unsigned int tortoise = x0, hare = step(a, c, x0);
+
+		//  find the length of the cycle
+	while (tortoise != hare)
+	{
+		if (power == lam)
+		{
+			tortoise = hare;
+			power <<= 1;
+			lam = 0;
+		}
+		hare = step(a, c, hare);
+		lam++;
+	}
+
+		//  find the first state on the cycle
+	tortoise = hare = x0;
+	for (unsigned long long i = 0; i < lam; i++) hare = step(a, c, hare);
+	while (tortoise != hare)
+	{
+		tortoise = step(a, c, tortoise);
+		hare = step(a, c, hare);
+		m++;
+	}
+	*lambda = lam, *mu = m;
+}
+
+
+
+/*
+ *     Print the cycle structure of a permutation, i.e. when a is odd.
+ */
+static void print_cycles(unsigned int a, unsigned int c)
+{
+	unsigned long long prev = 0, points, cycles, total = 0;
+
+	printf("\n    Cycle structure:\n\n");
+	printf("    %14s  %14s  %14s\n", "length", "cycles", "states");
+	puts("    ----------------------------------------------");
+	for (int k = 0; k <= BITS; k++)
+	{
+		points = fixed_points(a, c, k);					//  states with period dividing 2^k
+		cycles = (points - prev) >> k;					//  states with period exactly 2^k, per cycle
+		if (cycles) printf("    %14llu  %14llu  %14llu\n", 1ULL << k, cycles, points - prev);
+		total += cycles;
+		prev = points;
+	}
+	puts("    ----------------------------------------------");
+	printf("    %14s  %14llu  %14llu\n\n", "total", total, prev);
+}
+
+
+
+int main(int argc, char *argv[])
+{
+	unsigned int a    = GENERATOR_A;
+	unsigned int c    = GENERATOR_C;
+	unsigned int seed = 0x13b3e;						//  initial seed in rng.asm
+
+	if (argc == 2 || argc > 4)
+	{
+		printf("\n    Usage: period [a c [seed]]\n\n");
+		return 1;
+	}
+	if (argc >= 3) a = (unsigned int)strtoul(argv[1], NULL, 0), c = (unsigned int)strtoul(argv[2], NULL, 0);
+	if (argc == 4) seed = (unsigned int)strtoul(argv[3], NULL, 0);
+
+	unsigned int x0 = seed & GENERATOR_M;				//  only the 31 least significant bits matter
+
+	printf("\n\n               Period analysis of Xn+1 = (aXn + c) mod 2^31\n\n");
+	printf("    a = 0x%08x    c = 0x%08x    seed = 0x%08x\n\n", a, c, seed);
+
+	printf("    Full period conditions:\n");
+	printf("       c is odd:                %4s\n", (c & 1) ? "YES" : "NO");
+	printf("       a = 1 (mod 4):           %4s\n\n", ((a & 3) == 1) ? "YES" : "NO");
+
+		//  a is even, every state runs into a single fixed point
+	if (!(a & 1))
+	{
+		unsigned long long lambda, mu, longest = 1;
+		unsigned int fp = x0;
+		int s = 1;
+		for (int k = 0; k < BITS; k++) fp = step(a, c, fp);		//  a^31 = 0 (mod 2^31), so f^31 is constant
+
+			//  f^n(x) - fp = a^n(x - fp), so with a = 2^s * odd no tail is longer than 31 / s steps
+		if (a & GENERATOR_M)
+		{
+			while (!(a & (1u << s))) s++;
+			longest = (BITS + s - 1) / s;
+		}
+		brent(a, c, x0, &lambda, &mu);
+
+		printf("    a is even. The state map is not a permutation, every state ends up in\n");
+		printf("    the fixed point 0x%08x after at most %llu steps.\n\n", fp, longest);
+		printf("    Brent's algorithm from seed:\n");
+		printf("       cycle length:    %14llu\n", lambda);
+		printf("       tail length:     %14llu\n\n", mu);
+		return 0;
+	}
+
+		//  a is odd, the state map is a permutation
+	int threads = 1;
+#ifdef _OPENMP
+	threads = omp_get_max_threads();
+#endif
+
+	unsigned long long P = analytic_period(a, c, x0);
+	clock_t t = clock();
+	unsigned long long W = walk_period(a, c, x0);
+	t = clock() - t;
+
+	printf("    Period of seed:\n");
+	printf("       analytic:        %14llu  (HEX %9llx)\n", P, P);
+	printf("       state walk:      %14llu  (HEX %9llx, %d threads, %.2f s cpu)\n", W, W, threads, (double)t / CLOCKS_PER_SEC);
+	printf("       agree:           %14s\n", (P == W) ? "YES" : "NO");
+
+	print_cycles(a, c);
+
+	return (P == W) ? 0 : 1;
 }
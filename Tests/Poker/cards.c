@@ -33,17 +33,9 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "cards.h"
-
-
-
-#define ONE_PAIR             0x01
-#define TWO_PAIRS            0x02
-#define THREE_OF_A_KIND      0x04
-#define FOUR_OF_A_KIND       0x08
-#define STRAIGHT             0x10
-#define FLUSH                0x20
-#define ROYAL                0x40
+#include "handeval.h"
 
 
 
@@ -89,6 +81,29 @@ static void init_string(Card *c)
 
 
 
+/*
+ *     The 52 cards, shared by all decks. The deck only keeps the ratings of its cards, and
+ *     deals pointers to these, so no card is allocated or freed while playing.
+ */
+static Card cards[52] =
+{
+	{ 0,  2, 0, "\x05" "2"}, { 1,  2, 1, "\x04" "2"}, { 2,  2, 2, "\x03" "2"}, { 3,  2, 3, "\x06" "2"},
+	{ 4,  3, 0, "\x05" "3"}, { 5,  3, 1, "\x04" "3"}, { 6,  3, 2, "\x03" "3"}, { 7,  3, 3, "\x06" "3"},
+	{ 8,  4, 0, "\x05" "4"}, { 9,  4, 1, "\x04" "4"}, {10,  4, 2, "\x03" "4"}, {11,  4, 3, "\x06" "4"},
+	{12,  5, 0, "\x05" "5"}, {13,  5, 1, "\x04" "5"}, {14,  5, 2, "\x03" "5"}, {15,  5, 3, "\x06" "5"},
+	{16,  6, 0, "\x05" "6"}, {17,  6, 1, "\x04" "6"}, {18,  6, 2, "\x03" "6"}, {19,  6, 3, "\x06" "6"},
+	{20,  7, 0, "\x05" "7"}, {21,  7, 1, "\x04" "7"}, {22,  7, 2, "\x03" "7"}, {23,  7, 3, "\x06" "7"},
+	{24,  8, 0, "\x05" "8"}, {25,  8, 1, "\x04" "8"}, {26,  8, 2, "\x03" "8"}, {27,  8, 3, "\x06" "8"},
+	{28,  9, 0, "\x05" "9"}, {29,  9, 1, "\x04" "9"}, {30,  9, 2, "\x03" "9"}, {31,  9, 3, "\x06" "9"},
+	{32, 10, 0, "\x05" "10"}, {33, 10, 1, "\x04" "10"}, {34, 10, 2, "\x03" "10"}, {35, 10, 3, "\x06" "10"},
+	{36, 11, 0, "\x05" "J"}, {37, 11, 1, "\x04" "J"}, {38, 11, 2, "\x03" "J"}, {39, 11, 3, "\x06" "J"},
+	{40, 12, 0, "\x05" "Q"}, {41, 12, 1, "\x04" "Q"}, {42, 12, 2, "\x03" "Q"}, {43, 12, 3, "\x06" "Q"},
+	{44, 13, 0, "\x05" "K"}, {45, 13, 1, "\x04" "K"}, {46, 13, 2, "\x03" "K"}, {47, 13, 3, "\x06" "K"},
+	{48, 14, 0, "\x05" "A"}, {49, 14, 1, "\x04" "A"}, {50, 14, 2, "\x03" "A"}, {51, 14, 3, "\x06" "A"}
+};
+
+
+
 /*
  *     Creates a new card and returns a pointer to it
  *
@@ -102,7 +117,6 @@ Card *new_card(unsigned int rating)
 	c -> _rating = rating;
 	c -> _value = rating / 4 + 2;
 	c -> _suit = rating % 4;
-	c -> _next = NULL;
 	init_string(c);
 	return c;
 }
@@ -126,13 +140,25 @@ static int cmp_card(const void *a, const void *b)
  */
 void destroy_card(Card **c)
 {	
-	(*c) -> _next = NULL;
 	free(*c);
 	*c = NULL;	
 }
 
 
 
+/*
+ *     Returns a pointer to the card with a given rating. The card belongs to the deck module
+ *     and must not be changed or destroyed.
+ *
+ *     \param rating     A number between 0 and 51.
+ */
+Card *get_card(unsigned int rating)
+{
+	return &cards[(rating > 51) ? 51 : rating];
+}
+
+
+
 /***************************************************************************************************
  *                                                                                                 *
  *                                             Deck                                                *
@@ -140,44 +166,50 @@ void destroy_card(Card **c)
  ***************************************************************************************************/
  
 /*
- *     Creates a new deck of cards and returns a pointer to it. The deck is implemented as a linked list.
- *     This is significantly faster than using an array and sorting it between hands.
+ *     Creates a new deck of cards and returns a pointer to it.
  */
 Deck *new_deck()
 {
 	Deck *d = malloc(sizeof(Deck));
-	
-	d -> _cards = new_card(0);					//  get head of linked list
-	
-	Card *curr = d -> _cards;					//  keep track of end of linked list	
-	for (int c = 1; c < 52; c++)
-	{		
-		curr -> _next = new_card(c);				//  create new card
-		curr = curr -> _next;					//  increment current
-	}
-	d -> _size = 52;
+	if (d != NULL) init_deck(d);
 	return d;
 }
 
 
 
 /*
- *     Frees the memory associated with the deck, and sets all pointer to NULL
+ *     Fills a deck with all 52 cards. Used for decks that are not created by new_deck, f.ex.
+ *     one deck on the stack of each thread.
+ */
+void init_deck(Deck *d)
+{
+	for (int c = 0; c < 52; c++) d -> _cards[c] = (unsigned char)c;
+	d -> _size = 52;
+	d -> _mask = (1ULL << 52) - 1;
+	d -> _generator = NULL;
+}
+
+
+
+/*
+ *     Draw the cards of a deck from a generator instead of the global stream of rng.asm, so
+ *     decks in different threads do not share a seed.
+ *
+ *     \param *d     Pointer to the deck.
+ *     \param *g     Pointer to the generator, or NULL to go back to rng.asm.
+ */
+void set_generator(Deck *d, Generator *g)
+{
+	d -> _generator = g;
+}
+
+
+
+/*
+ *     Frees the memory associated with the deck, and sets the pointer to NULL
  */
 void destroy_deck(Deck **d)
 {
-	Card *current = (*d) -> _cards;
-	Card *next = NULL;
-	
-		//  traverse the linked list and destroy all cards
-	while (current != NULL)
-	{
-		next = current -> _next;
-		destroy_card(&current);
-		current = next;
-	}
-	
-	(*d) -> _cards = NULL;
 	free(*d);
 	*d = NULL;		
 }
@@ -192,46 +224,22 @@ void destroy_deck(Deck **d)
  *     \return       A pointer to the card that was dealt.
  *
  *     Note:   Cards are not dealt from the top of the deck, but drawn at random from
- *             the list of cards. This way, the deck is always sorted and no shuffeling
- *             is needed.
+ *             the array of cards, so no shuffeling is needed. The last card in the array
+ *             takes the place of the card that is dealt, so a card is dealt in constant time.
  */
 Card *deal_card(Deck *d)
 {
 		//  if deck is empty, return NULL
 	if (d -> _size == 0) return NULL;
 	
-	int index = rndint(0, --(d -> _size));			//  select random card from the _cards list, and decrement deck size
-	Card *c = d -> _cards;					//  temporary card is first card in deck
-
-		//  if index is the first card in deck;
-	if (index == 0)
-	{
-		d -> _cards = c -> _next;
-		goto done;
-	}
-	
-	Card *prev = c;
-	c = c -> _next;
-	
-		//  look up indexed card
-	for (int i = 1; i != index; i++)
-	{
-		prev = c;
-		c = c -> _next;
-	}
+		//  select random card from the _cards array, and decrement deck size
+	int last  = --(d -> _size);
+	int index = (d -> _generator != NULL) ? generator_rndint(d -> _generator, 0, last) : rndint(0, last);
+	unsigned char rating = d -> _cards[index];
 	
-		//  if last element
-	if (index == d -> _size)
-	{
-		prev -> _next = NULL;
-		return c;					//  _next is already NULL
-	}
-	
-	prev -> _next = c -> _next;
-	
-done:	
-	c -> _next = NULL;					//  can't access the rest of the deck through this card
-	return c;
+	d -> _cards[index] = d -> _cards[d -> _size];		//  move last card into the hole
+	d -> _mask &= ~(1ULL << rating);
+	return &cards[rating];
 }
 
 
@@ -242,45 +250,19 @@ done:
  *     \param *d     Pointer to the deck to which the card is returned
  *     \param *c     Pointer to the card that is returned.
  *
- *     \return       0 if card is accepted, 1 if it is
+ *     \return       0 if card is accepted, 1 if it is rejected because the deck is full
+ *                   or the card is already in the deck.
  *
- *     Note:   It is advisable not to operate with more than one deck.
+ *     Note:   The card is added to the end of the array in constant time. A card made by
+ *             new_card is accepted, but the deck deals the shared card with the same rating.
  */
 int return_card(Deck *d, Card *c)
 {	
-		//  don't accept a card in a full deck
-	if (d -> _size == 52) return 0;
-		
-	++(d -> _size);
-		
-		//  if first card
-	if (c -> _rating < d -> _cards -> _rating)
-	{
-		c -> _next = d -> _cards;
-		d -> _cards = c;
-		return 0;
-	}
-	
-		//  find insertion point
-	Card *prev = d -> _cards;
-	Card *curr = prev -> _next;
-	while (c -> _rating > curr -> _rating && curr -> _next != NULL)
-	{
-		prev = curr;
-		curr = curr -> _next;
-	}
-	
-		//  if last card
-	if (c -> _rating > curr -> _rating)
-	{
-		curr -> _next = c;
-		return 1;
-	}
+	if (d -> _size == 52 || c -> _rating > 51 || (d -> _mask >> c -> _rating & 1)) return 1;
 	
-	prev -> _next = c;
-	c -> _next = curr;
-	
-	return 1;
+	d -> _cards[(d -> _size)++] = c -> _rating;
+	d -> _mask |= 1ULL << c -> _rating;
+	return 0;
 }
 
 
@@ -292,18 +274,13 @@ int return_card(Deck *d, Card *c)
  ***************************************************************************************************/
 
 static  int hand_size(Hand *h);
-static void sort_hand(Hand *h);
-static  int rate_hand(Hand *h);
  
 /*
  *     Creates a new hand and returns a pointer to it.
  */
 Hand *new_hand()
 {	
-	Hand *h = (Hand *)calloc(1, sizeof(Hand));	
-	strcpy(h -> _description, "UNRATED");	
-	
-	return h;
+	return (Hand *)calloc(1, sizeof(Hand));
 }
 
 
@@ -337,11 +314,12 @@ int add_card(Deck *d, Hand *h)
 	
 	h -> _cards[(h -> _size)++] = deal_card(d);
 		
-		//  if hand has 5 cards, sort and evaluate
+		//  if hand has 5 cards, evaluate
 	if (h -> _size == 5)
-	{		
-		sort_hand(h);		
-		rate_hand(h);
+	{
+		unsigned char codes[5];
+		for (int i = 0; i < 5; i++) codes[i] = h -> _cards[i] -> _rating;
+		h -> _rating = handeval_5(codes);
 	}
 	
 	return h -> _size;
@@ -365,7 +343,6 @@ int drop_card(Deck *d, Hand *h, unsigned int i)
 	
 		//  reset rating. A hand with less than 5 cards has no rating
 	h -> _rating = 0;
-	strcpy(h -> _description, "UNRATED");
 	
 		//  if the index is the last card, then just set the index to NULL
 	if (i == h -> _size)
@@ -394,136 +371,14 @@ int hand_size(Hand *h)
 
 
 /*
- *     Sort a deck
+ *     Get the description of the rating of a hand, f.ex. "FULL HOUSE".
  *
- *     \param *d    Pointer to the deck to be sorted.
- *
- *     Note:    The cards are sorted from low to high card
+ *     Note:    The description is looked up when it is asked for, so rating a hand does
+ *              not copy any strings.
  */
-static void sort_hand(Hand *h)
-{		
-	qsort(h -> _cards, h -> _size, sizeof(Card*), cmp_card);		
-}
-
-
-
-/*
- *     Calculate a score for a given poker hand
- *
- *     \param *h    Pointer to the hand to score.
- *
- *     \return      A score from 0 to 9
- *
- *     Note:    A score from 0 (No Pair/High Card) to 9 (Royal Flush) is assigned
- *              to the hand. This score is used in the main program to categorize
- *              poker hands into ten categories. The score could also be used to
- *              compare poker hands, but there is not need for this in a poker test.
- */
-static int rate_hand(Hand *h)
-{	
-		//  a hand with less than 5 cards has no rating.
-	if (h -> _size < 5) return 0;
-
-		//  default rating
-	h -> _rating = 0;
-	strcpy(h -> _description, "HIGH CARD");	
-	
-		//  make 13 bins and sort cards into bins by value (2, 3, ..., K, A)
-	int values[13] = {0}, i;
-	for (i = 0; i < h -> _size; i++) values[h -> _cards[i] -> _value - 2]++;
-	
-		//  look through the bins, count pairs, three and four of a kind
-	int pairs = 0, three = 0, four = 0;
-	for (i = 0; i < 13; i++)
-	{
-		switch(values[i])
-		{
-			case 2:  pairs++; break;
-			case 3:  three++; break;
-			case 4:  four++;  break;
-			default:          break;					//  if 0 or 1, do nothing
-		}
-	}
-	
-		//  use 8 bits to keep track of properties (one pair, three of a kind, flush, straight etc.)
-	unsigned char properties = 0;
-	properties |= (pairs == 1) * ONE_PAIR | (pairs == 2) * TWO_PAIRS | three * THREE_OF_A_KIND | four * FOUR_OF_A_KIND;
-	
-	if (properties)
-	{
-		switch(properties)
-		{
-			case 0x01:
-				h -> _rating = 1;				
-				strcpy(h -> _description, "ONE PAIR");
-				break;
-			case 0x02:
-				h -> _rating = 2;				
-				strcpy(h -> _description, "TWO PAIRS");
-				break;
-			case 0x04:
-				h -> _rating = 3;				
-				strcpy(h -> _description, "THREE OF A KIND");
-				break;
-			case 0x05:
-				h -> _rating = 6;				
-				strcpy(h -> _description, "FULL HOUSE");
-				break;
-			case 0x08:
-				h -> _rating = 7;				
-				strcpy(h -> _description, "FOUR OF A KIND");
-				break;
-			default: break;							//  impossible if properties != 0
-		}		
-				//  more than one of  a kind rules out straight and flush, so return early
-		return h -> _rating;
-	}
-	
-		//  look for straights. flags uses 13 bits to keep track of different card values.
-		//  f.ex. c3, h5, s5, sJ, dQ = 0 0110 0000 1010 while s3, h4, s5, d6, c7 = 0 0000 0011 1110
-		//  five 1's in a row indicates a straight
-	unsigned short int flags = 0, flag = 1;
-	for (i = 0; i < h -> _size; i++) flags |= flag << h -> _cards[i] -> _value - 2;
-	
-		//  look for the straight bit pattern. 0x1f is the pattern 1 1111. 	
-	for (flag = 0x1f; flags != flag && flag <= 0x3e00; flag <<= 1);
-	
-		//  2, 3, 4, 5, A (0x100f) also counts as a straight. look for this pattern
-		//  at this point, properties = 0 (no more than one of a kind)
-	properties |= STRAIGHT * ((flag <= 0x1f00) | (flags == 0x100f));
-	
-		//  look for a flush. the criterion is that all cards have the same suit as the first	
-	for (i = 1; i < 5 && (h -> _cards[i] -> _suit) == (h -> _cards[0] -> _suit); i++);	
-	properties |= FLUSH * (i == 5);
-	
-		//  if flush, check for royal straight	
-	properties |= ROYAL * ((i == 5) && (flags == 0x1f00));
-	
-	if (properties)
-	{
-		switch(properties)
-		{
-			case 0x10:
-				h -> _rating = 4;				
-				strcpy(h -> _description, "STRAIGHT");
-				break;
-			case 0x20:
-				h -> _rating = 5;				
-				strcpy(h -> _description, "FLUSH");
-				break;
-			case 0x30:
-				h -> _rating = 8;				
-				strcpy(h -> _description, "STRAIGHT FLUSH");				
-				break;
-			case 0x70:							//  STRAIGHT | FLUSH | ROYAL
-				h -> _rating = 9;				
-				strcpy(h -> _description, "ROYAL FLUSH");
-				break;			
-			default:				
-				break;
-		}
-	}	
-	return h -> _rating;
+const char *hand_description(Hand *h)
+{
+	return (h -> _size < 5) ? "UNRATED" : handeval_name(h -> _rating);
 }
 
 
@@ -534,16 +389,22 @@ static int rate_hand(Hand *h)
  *     \param *h     A pointer to the hand.
  *     \param *str   A pointer to the character array receiving the string
  *     \param  n     Max number of characters to write to str. Usually equals buffer size
+ *
+ *     Note:    The cards are listed from low to high card. The hand itself is not sorted.
  */ 
 void hand_to_string(Hand *h, char *str, int n)
 {
 	if (h -> _size == 0) return;	
 	*str = 0;									//  make sure buffer is empty before concatenating
 	
+	Card *sorted[5];
+	for (int i = 0; i < h -> _size; i++) sorted[i] = h -> _cards[i];
+	qsort(sorted, h -> _size, sizeof(Card*), cmp_card);
+	
 	for (int i = 0; i < h -> _size; i++)
 	{
-		strncat(str, h -> _cards[i] -> _string, n);
-		n -= strlen(h -> _cards[i] -> _string);
+		strncat(str, sorted[i] -> _string, n);
+		n -= strlen(sorted[i] -> _string);
 		strncat(str, (i == h -> _size - 1 ? "\n" : " "), n--);		
 		
 		if (n <= 0) break;
@@ -32,35 +32,41 @@
 
 #pragma once
 
+#include "generator.h"
+
 
 /*
  *     Card
  */
 typedef struct card
 {
-	int  _rating;							//  0 - 51: 0 is the two of clubs and 51 is the ace of spades
-	int  _value;							//  2, 3, ...,10, j, Q, K, A
-	int  _suit;							//  0 = clubs, 1 = diamonds, 2 = hearts, 3 = spades
-	char _string[4];						//  _value and a symbol correpsonding to _suit
-	struct card *_next;	
+	unsigned char _rating;						//  0 - 51: 0 is the two of clubs and 51 is the ace of spades
+	unsigned char _value;						//  2, 3, ...,10, j, Q, K, A
+	unsigned char _suit;						//  0 = clubs, 1 = diamonds, 2 = hearts, 3 = spades
+	char          _string[4];					//  _value and a symbol correpsonding to _suit
 } Card;
 
 Card *new_card(unsigned int rating);					//  Returns a pointer to a new card 
 void  destroy_card(Card **c);						//  Free memory associated with this card
+Card *get_card(unsigned int rating);					//  Returns a pointer to the shared, constant card
 
 
 
 /*
  *     Deck
- *     Deck is a linked list with functions for accessing elements
+ *     Deck is an array of card codes, cards are dealt and returned in constant time
  */
 typedef struct
 {
-	Card *_cards;							//  This is the head of a linked list
-	int _size;							//  current number of cards in the deck
+	unsigned char      _cards[52];					//  ratings of the cards in the deck, in no particular order
+	int                _size;					//  current number of cards in the deck
+	unsigned long long _mask;					//  bit r is set if the card with rating r is in the deck
+	Generator         *_generator;					//  stream the cards are drawn from, NULL for rng.asm
 } Deck;
 
 Deck *new_deck();							//  Returns a pointer to a new deck
+void  init_deck(Deck *d);						//  Fills a deck that is not allocated by new_deck
+void  set_generator(Deck *d, Generator *g);				//  Draws the cards from g instead of rng.asm
 void  destroy_deck(Deck **d);						//  Frees the memory associated with the deck
 Card *deal_card(Deck *d);						//  Returns a pointer to a card, removes the card from the deck
  int  return_card(Deck *d, Card *c);					//  Adds a card to the deck
@@ -75,7 +81,6 @@ typedef struct
 	Card *_cards[5];						//  A hand has max 5 cards
 	int   _size;							//  current number of cards in the hand
 	int   _rating;							//  0 - 9: 0 is high card, 9 is a royal flush
-	char  _description[16];						//  "HIGH CARD", "ONE PAIR", etc
 } Hand;
 
 Hand *new_hand();							//  Returns to a new hand
@@ -83,3 +88,4 @@ void  destroy_hand(Hand **h);						//  Frees memory associated with the hand. Ha
  int  add_card(Deck *d, Hand *h);					//  Add a card from a given deck to the hand
  int  drop_card(Deck *d, Hand *h, unsigned int i);			//  Drop a card and return it to a given deck 
 void  hand_to_string(Hand *h, char *buffer, int n);			//  Produces a text representation of the hand
+const char *hand_description(Hand *h);					//  "HIGH CARD", "ONE PAIR", etc, "UNRATED" if less than 5 cards
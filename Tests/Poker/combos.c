@@ -0,0 +1,221 @@
+/*
+ * combos.c
+ *
+ * Created: 18. Oct. 2026
+ *  Author: Frank Bjørnø
+ *
+ * Purpose:
+ *      Enumerate all combinations of k cards from a deck of n cards, in parallel, and count
+ *      them by category for exact expected frequencies.
+ *
+ * License:
+ *
+ *          Copyright (C) 2026 Frank Bjørnø
+ *
+ *          1. Permission is hereby granted, free of charge, to any person obtaining a copy
+ *          of this software and associated documentation files (the "Software"), to deal
+ *          in the Software without restriction, including without limitation the rights
+ *          to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ *          of the Software, and to permit persons to whom the Software is furnished to do
+ *          so, subject to the following conditions:
+ *
+ *          2. The above copyright notice and this permission notice shall be included in all
+ *          copies or substantial portions of the Software.
+ *
+ *          3. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *          INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ *          PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *          HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ *          CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ *          OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "combos.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#define _BLOCK     4096						//  hands rated at a time
+#define _CHUNKS    256						//  chunks of work per thread, at least
+
+
+
+/*
+ *     Compute the binomial coefficient C(n, k) exactly.
+ *
+ *     \return     C(n, k), 0 if k < 0 or k > n.
+ *
+ *     Note:  C(n, i) = C(n, i - 1) * (n - i + 1) / i is always an integer, and no product is
+ *            larger than k times the answer, which is enough for n <= 64.
+ */
+unsigned long long combos_binomial(int n, int k)
+{
+	if (k < 0 || k > n) return 0;
+	if (k > n - k) k = n - k;
+
+	unsigned long long c = 1;
+	for (int i = 1; i <= k; i++) c = c / i * (n - i + 1) + c % i * (n - i + 1) / i;
+	return c;
+}
+
+
+
+/*
+ *     The next combination in colex order, Gosper's hack.
+ *
+ *     \param  x     A combination, the cards are the bits that are set.
+ *
+ *     \return       The smallest number larger than x with the same number of bits set.
+ *
+ *     Note:  The lowest run of ones is moved up one place, and the rest of the run is
+ *            moved down to bit 0. The combination after the last one of n cards has bit n
+ *            set.
+ */
+uint64_t combos_next(uint64_t x)
+{
+	uint64_t low  = x & (0 - x);					//  lowest bit that is set
+	uint64_t high = x + low;					//  the run carried one place up
+	return high | (((x ^ high) / low) >> 2);
+}
+
+
+
+/*
+ *     The combination with a given rank in colex order.
+ *
+ *     \param  rank  0 - C(n, k) - 1. Rank 0 is the cards 0, 1, ..., k - 1.
+ *     \param  k     Number of cards.
+ *
+ *     \return       The combination, the cards are the bits that are set.
+ *
+ *     Note:  The rank of the cards c1 < c2 < ... < ck is C(c1, 1) + C(c2, 2) + ... + C(ck, k),
+ *            so the cards are found from the highest down as the largest c with C(c, i) not
+ *            larger than what remains of the rank.
+ */
+uint64_t combos_unrank(unsigned long long rank, int k)
+{
+	uint64_t x = 0;
+	int      c = COMBOS_MAXN;
+
+	for (int i = k; i > 0; i--)
+	{
+		do c--; while (combos_binomial(c, i) > rank);
+		rank -= combos_binomial(c, i);
+		x |= 1ULL << c;
+	}
+	return x;
+}
+
+
+
+/*
+ *     Index of the lowest set bit of a nonzero 64 bit word.
+ */
+static unsigned int _ctz(uint64_t x)
+{
+#if defined(_MSC_VER) && defined(_M_X64)
+	unsigned long i;
+	_BitScanForward64(&i, x);
+	return (unsigned int)i;
+#elif defined(_MSC_VER)
+	unsigned long i;
+	if ((unsigned int)x) _BitScanForward(&i, (unsigned int)x);
+	else _BitScanForward(&i, (unsigned int)(x >> 32)), i += 32;
+	return (unsigned int)i;
+#elif defined(__GNUC__)
+	return (unsigned int)__builtin_ctzll(x);
+#else
+	unsigned int i = 0;
+	while (!(x & 1)) x >>= 1, i++;
+	return i;
+#endif
+}
+
+
+
+/*
+ *     Write the cards of a combination as codes, lowest first.
+ */
+static void _codes(unsigned char *codes, uint64_t x)
+{
+	for (; x; x &= x - 1) *codes++ = (unsigned char)_ctz(x);
+}
+
+
+
+/*
+ *     Count all combinations of k cards from a deck of n cards by category.
+ *
+ *     \param *count       Receives the number of combinations in each category.
+ *     \param  categories  Number of categories, the ratings must be less than this.
+ *     \param  n           Cards in the deck, 1 - 64, coded 0 - n - 1.
+ *     \param  k           Cards in a hand, 1 - n.
+ *     \param  rate        The function rating the hands.
+ *
+ *     \return             0 on success, 1 if memory could not be allocated, 2 if n or k is
+ *                         out of range.
+ *
+ *     Note:  The combinations are split into chunks of consecutive ranks. A chunk starts at
+ *            the combination found by combos_unrank and steps through the rest with
+ *            combos_next, and the hands are rated _BLOCK at a time. Every thread counts in a
+ *            histogram of its own, and the counts are exact integers, so the result is the
+ *            same for any number of threads. The sum of the counts is C(n, k).
+ */
+int combos_count(unsigned long long *count, int categories, int n, int k, RATE rate)
+{
+	if (n < 1 || n > COMBOS_MAXN || k < 1 || k > n || categories < 1) return 2;
+
+	unsigned long long total  = combos_binomial(n, k);
+	unsigned long long chunk  = total / _CHUNKS + 1;
+	long long          chunks = (long long)((total + chunk - 1) / chunk);
+	int                fail   = 0;
+
+	memset(count, 0, categories * sizeof(unsigned long long));
+
+#pragma omp parallel
+	{
+		unsigned long long *local  = (unsigned long long *)calloc(categories, sizeof(unsigned long long));
+		unsigned char      *codes  = (unsigned char *)malloc((size_t)_BLOCK * k);
+		unsigned char      *rating = (unsigned char *)malloc(_BLOCK);
+		if (local == NULL || codes == NULL || rating == NULL)
+		{
+#pragma omp atomic write
+			fail = 1;
+		}
+
+#pragma omp for schedule(dynamic)
+		for (long long j = 0; j < chunks; j++)
+		{
+			int stop;
+#pragma omp atomic read
+			stop = fail;
+			if (stop) continue;
+
+			unsigned long long first = (unsigned long long)j * chunk;
+			unsigned long long left  = (total - first < chunk) ? total - first : chunk;
+			uint64_t           x     = combos_unrank(first, k);
+
+			while (left > 0)
+			{
+				size_t m = (left < _BLOCK) ? (size_t)left : _BLOCK;
+				for (size_t i = 0; i < m; i++, x = combos_next(x)) _codes(codes + i * k, x);
+				rate(rating, codes, m);
+				for (size_t i = 0; i < m; i++) local[rating[i]]++;
+				left -= m;
+			}
+		}
+
+#pragma omp critical
+		if (local != NULL) for (int c = 0; c < categories; c++) count[c] += local[c];
+
+		free(local);
+		free(codes);
+		free(rating);
+	}
+	return fail;
+}
@@ -0,0 +1,51 @@
+/*
+ * combos.h
+ *
+ * Created: 18. Oct. 2026
+ *  Author: Frank Bjørnø
+ *
+ * Purpose:
+ *      Enumerate all combinations of k cards from a deck of n cards, in parallel, and count
+ *      them by category for exact expected frequencies.
+ *
+ * License:
+ *
+ *          Copyright (C) 2026 Frank Bjørnø
+ *
+ *          1. Permission is hereby granted, free of charge, to any person obtaining a copy
+ *          of this software and associated documentation files (the "Software"), to deal
+ *          in the Software without restriction, including without limitation the rights
+ *          to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ *          of the Software, and to permit persons to whom the Software is furnished to do
+ *          so, subject to the following conditions:
+ *
+ *          2. The above copyright notice and this permission notice shall be included in all
+ *          copies or substantial portions of the Software.
+ *
+ *          3. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *          INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ *          PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *          HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ *          CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ *          OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define COMBOS_MAXN    64						//  the cards of a combination are the bits of a 64 bit word
+
+
+/*
+ *     Rate n hands of k cards each. rating[i] is the category of the hand codes[i*k], ...,
+ *     codes[i*k + k - 1]. handeval_batch is a RATE for k = 5.
+ */
+typedef void (*RATE)(unsigned char *rating, const unsigned char *codes, size_t n);
+
+unsigned long long combos_binomial(int n, int k);
+uint64_t           combos_next(uint64_t x);
+uint64_t           combos_unrank(unsigned long long rank, int k);
+int                combos_count(unsigned long long *count, int categories, int n, int k, RATE rate);
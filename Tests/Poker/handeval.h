@@ -0,0 +1,46 @@
+/*
+ * handeval.h
+ *
+ * Created: 18. Oct. 2026
+ *  Author: Frank Bjørnø
+ *
+ * Purpose:
+ *      Rate five card poker hands from the card codes, without sorting, and find the
+ *      strength of the best five cards of seven, one hand at a time or eight at a time
+ *      with AVX2.
+ *
+ * License:
+ *
+ *          Copyright (C) 2026 Frank Bjørnø
+ *
+ *          1. Permission is hereby granted, free of charge, to any person obtaining a copy
+ *          of this software and associated documentation files (the "Software"), to deal
+ *          in the Software without restriction, including without limitation the rights
+ *          to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ *          of the Software, and to permit persons to whom the Software is furnished to do
+ *          so, subject to the following conditions:
+ *
+ *          2. The above copyright notice and this permission notice shall be included in all
+ *          copies or substantial portions of the Software.
+ *
+ *          3. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *          INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ *          PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *          HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ *          CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ *          OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <stddef.h>
+
+#define HANDEVAL_CATEGORIES   10					//  0 is high card, 9 is a royal flush
+#define HANDEVAL_CATEGORY(s)  ((int)((s) >> 26))			//  the rating of a strength from handeval_7
+
+int          handeval_5(const unsigned char *codes);
+void         handeval_batch(unsigned char *rating, const unsigned char *codes, size_t n);
+unsigned int handeval_7(const unsigned char *codes);
+void         handeval_batch7(unsigned int *strength, const unsigned char *codes, size_t n);
+const char *handeval_name(int rating);
@@ -0,0 +1,217 @@
+/*
+ * holdem.c
+ *
+ * Created: 18. Oct. 2026
+ *  Author: Frank Bjørnø
+ *
+ * Purpose:
+ *      Estimate the equity of a Texas hold'em starting hand against 1 - 8 opponents with
+ *      random hands, by Monte Carlo simulation of the rest of the deal.
+ *
+ * Usage:
+ *      holdem hand [players [trials [seed]]]
+ *
+ *      hand is the two hole cards, f.ex. AsKd or Th9h: the value 2 - 9, T, J, Q, K or A and
+ *      the suit c, d, h or s. players is 2 - 9, 2 by default, and trials is 10^7 by default.
+ *      The equity is the share of the pot the hand wins on average, with a pot that is split
+ *      between the players who tie for the best hand.
+ *
+ * Compilation:
+ *     From the command line with Microsoft (R) C/C++ Optimizing Compiler.
+ *
+ *      1. Compile and link the program using the command
+ *         cl /O2 /arch:AVX2 /openmp holdem.c handeval.c generator.c
+ *
+ * License:
+ *
+ *          Copyright (C) 2026 Frank Bjørnø
+ *
+ *          1. Permission is hereby granted, free of charge, to any person obtaining a copy
+ *          of this software and associated documentation files (the "Software"), to deal
+ *          in the Software without restriction, including without limitation the rights
+ *          to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ *          of the Software, and to permit persons to whom the Software is furnished to do
+ *          so, subject to the following conditions:
+ *
+ *          2. The above copyright notice and this permission notice shall be included in all
+ *          copies or substantial portions of the Software.
+ *
+ *          3. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *          INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ *          PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *          HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ *          CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ *          OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "handeval.h"
+#include "generator.h"
+
+#define PLAYERS    2
+#define TRIALS     10000000ULL
+#define SEED       0x13b3e						//  the initial seed of rng.asm
+#define CHUNK      65536						//  trials in a chunk, the unit of parallel work
+#define BLOCK      256						//  trials evaluated at a time
+#define MAXP       9							//  most players at the table
+#define SHARES     2520							//  divisible by 1, 2, ..., 9, the ways to split a pot
+
+
+/*
+ *     The results of a number of trials
+ */
+typedef struct
+{
+	unsigned long long _wins;					//  trials where the hand alone is best
+	unsigned long long _ties;					//  trials where the hand ties for best
+	unsigned long long _shares;					//  the pots won, in units of 1 / SHARES
+} Result;
+
+
+
+/*
+ *     Read a card, f.ex. "As", and return its code, 0 - 51 as the _rating of a Card, or -1.
+ */
+static int card(const char *s)
+{
+	const char *values = "23456789TJQKA", *suits = "cdhs";
+	const char *v = (s[0] != 0) ? strchr(values, s[0]) : NULL;
+	const char *u = (s[0] != 0 && s[1] != 0) ? strchr(suits, s[1]) : NULL;
+	return (v == NULL || u == NULL) ? -1 : (int)(v - values) * 4 + (int)(u - suits);
+}
+
+
+
+/*
+ *     Play one chunk of trials from its own place in the stream.
+ *
+ *     \param *r        Receives the results of the chunk.
+ *     \param  hole     The codes of the two hole cards.
+ *     \param  players  Players at the table, 2 - MAXP.
+ *     \param  first    Number of the first trial in the chunk.
+ *     \param  trials   Number of trials in the chunk.
+ *     \param  seed     Seed of the stream.
+ *
+ *     Note:   The deck of the chunk is the 50 cards the hole cards leave, found from a 52 bit
+ *             mask. The board and the opponents' cards are dealt by a partial shuffle that
+ *             takes exactly one number from the stream per card, read from a view, so every
+ *             chunk knows where its numbers start. The seven cards of every player are
+ *             written out for BLOCK trials at a time and evaluated with handeval_batch7.
+ */
+static void play(Result *r, const int *hole, int players, unsigned long long first, unsigned long long trials, unsigned int seed)
+{
+	unsigned char      deck[52], codes[BLOCK * MAXP * 7];
+	unsigned int       strength[BLOCK * MAXP];
+	unsigned long long mask = ((1ULL << 52) - 1) & ~(1ULL << hole[0]) & ~(1ULL << hole[1]);
+	int                size = 0, deal = 5 + 2 * (players - 1);
+	View               v;
+
+	for (int c = 0; c < 52; c++) if (mask >> c & 1) deck[size++] = (unsigned char)c;
+	view_init(&v, GV_RAW, seed);
+	generator_jump(&v._gen, first * deal);
+	memset(r, 0, sizeof(Result));
+
+	for (unsigned long long done = 0; done < trials; done += BLOCK)
+	{
+		int m = (trials - done < BLOCK) ? (int)(trials - done) : BLOCK;
+
+		for (int t = 0; t < m; t++)
+		{
+				//  deal the board and the opponents' cards to the front of the deck
+			for (int i = 0; i < deal; i++)
+			{
+				int           j    = i + (int)(view_raw(&v) % (unsigned int)(size - i));
+				unsigned char temp = deck[i];
+				deck[i] = deck[j], deck[j] = temp;
+			}
+
+				//  player 0 holds the hand, the others hold deck[5], deck[6], ...
+			for (int p = 0; p < players; p++)
+			{
+				unsigned char *h = codes + (t * players + p) * 7;
+				h[0] = (unsigned char)((p == 0) ? hole[0] : deck[5 + 2 * (p - 1)]);
+				h[1] = (unsigned char)((p == 0) ? hole[1] : deck[6 + 2 * (p - 1)]);
+				memcpy(h + 2, deck, 5);
+			}
+		}
+		handeval_batch7(strength, codes, (size_t)m * players);
+
+			//  compare the hand to the best of the opponents
+		for (int t = 0; t < m; t++)
+		{
+			const unsigned int *s = strength + t * players;
+			unsigned int best = 0;
+			int          tied = 1;
+			for (int p = 1; p < players; p++)
+			{
+				if (s[p] > best) best = s[p], tied = 1;
+				else if (s[p] == best) tied++;
+			}
+			r -> _wins   += (s[0] > best);
+			r -> _ties   += (s[0] == best);
+			r -> _shares += (s[0] > best) ? SHARES : (s[0] == best) ? SHARES / (tied + 1) : 0;
+		}
+	}
+}
+
+
+
+int main(int argc, char *argv[])
+{
+	int                players = (argc > 2) ? atoi(argv[2]) : PLAYERS;
+	unsigned long long total   = (argc > 3) ? strtoull(argv[3], NULL, 0) : TRIALS;
+	unsigned int       seed    = (argc > 4) ? (unsigned int)strtoul(argv[4], NULL, 0) : SEED;
+	int                hole[2] = {-1, -1};
+
+	if (argc > 1 && strlen(argv[1]) == 4) hole[0] = card(argv[1]), hole[1] = card(argv[1] + 2);
+	if (argc < 2 || argc > 5 || hole[0] < 0 || hole[1] < 0 || hole[0] == hole[1] || players < 2 || players > MAXP || total < 1)
+	{
+		printf("\n    Usage: holdem hand [players [trials [seed]]], f.ex. holdem AsKd 6, 2 <= players <= %d\n\n", MAXP);
+		return 1;
+	}
+
+	int deal = 5 + 2 * (players - 1);
+	if ((double)total * deal > 2147483648.0) printf("\n    Note: the trials take more than the period of the generator and repeat.\n");
+
+		//  play the trials in chunks on all cores, and add up the results in order
+	long long chunks = (long long)((total + CHUNK - 1) / CHUNK);
+	Result   *part   = (Result *)malloc(chunks * sizeof(Result));
+	Result    all    = {0};
+	if (part == NULL)
+	{
+		printf("\n    Unable to allocate memory.\n\n");
+		return 1;
+	}
+
+#pragma omp parallel for schedule(dynamic)
+	for (long long k = 0; k < chunks; k++)
+	{
+		unsigned long long first = (unsigned long long)k * CHUNK;
+		play(&part[k], hole, players, first, (total - first < CHUNK) ? total - first : CHUNK, seed);
+	}
+
+	for (long long k = 0; k < chunks; k++)
+	{
+		all._wins   += part[k]._wins;
+		all._ties   += part[k]._ties;
+		all._shares += part[k]._shares;
+	}
+	free(part);
+
+		//  present the estimates, with 95% confidence intervals of the win and tie rates
+	double n      = (double)total;
+	double win    = all._wins / n, tie = all._ties / n;
+	double equity = all._shares / (n * SHARES);
+
+	printf("\n\n    %s against %d random hand%s, %llu trials\n\n", argv[1], players - 1, (players > 2) ? "s" : "", total);
+	printf("    Win:      %8.4f %%  +/- %.4f %%\n", 100.0 * win, 196.0 * sqrt(win * (1.0 - win) / n));
+	printf("    Tie:      %8.4f %%  +/- %.4f %%\n", 100.0 * tie, 196.0 * sqrt(tie * (1.0 - tie) / n));
+	printf("    Equity:   %8.4f %%\n\n", 100.0 * equity);
+
+	return 0;
+}
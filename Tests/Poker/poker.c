@@ -8,6 +8,12 @@
  *      Play 2598960 poker hands and analyze the frequency of each kind of hand
  *      using a chi square goodness of fit test.
  *
+ * Usage:
+ *      poker [N [seed]]
+ *
+ *      Plays N hands, 2598960 by default, on all cores. The rare hands need 10^10 hands or
+ *      more before the test means anything.
+ *
  * Compilation:
  *     From the command line with Microsoft (R) Macro Assembler and 
  *                                Microsoft (R) C/C++ Optimizing Compiler.
@@ -15,7 +21,7 @@
  *      1. Assemble rng.asm without linking using the command
  *         ml /c rng.asm
  *      2. Compile and link the program using the command
- *         cl poker.c cards.c statistics.c rng.obj
+ *         cl /O2 /arch:AVX2 /openmp poker.c cards.c handeval.c combos.c generator.c statistics.c rng.obj
  *
  * License:
  * 
@@ -40,45 +46,111 @@
  */
 
 
-#define CARDS_IN_A_HAND    5
+#include <stdio.h>
+#include <stdlib.h>
 
 #include "cards.h"
+#include "handeval.h"
+#include "combos.h"
+#include "generator.h"
 #include "statistics.h"
 
-extern unsigned randomize(void);
+#define CARDS_IN_A_HAND    5
+#define N                  2598960ULL				//  default number of hands, C(52, 5)
+#define SEED               0x13b3e					//  the initial seed of rng.asm
+#define CHUNK              65536					//  hands in a chunk, the unit of parallel work
+
 
-int main(void)
-{		
-	randomize();	
-	int N = 2598960;
-	
+
+/*
+ *     Play one chunk of hands with a deck and a hand of its own, from the chunk's own place
+ *     in the stream, and count the kinds of hands.
+ *
+ *     \param *count    The histogram of the thread, HANDEVAL_CATEGORIES counters.
+ *     \param  first    Number of the first hand in the chunk.
+ *     \param  hands    Number of hands in the chunk.
+ *     \param  seed     Seed of the stream.
+ *
+ *     Note:   Every hand takes exactly CARDS_IN_A_HAND numbers from the stream, and every
+ *             chunk starts with a full deck in the same order, so the counts do not depend
+ *             on the number of threads or on which thread plays the chunk.
+ */
+static void play(unsigned long long *count, unsigned long long first, unsigned long long hands, unsigned int seed)
+{
+	Generator g;
+	Deck      deck;
+	Hand      hand = {0};
+
+	generator_init(&g, seed);
+	generator_jump(&g, first * CARDS_IN_A_HAND);
+	init_deck(&deck);
+	set_generator(&deck, &g);
+
+	for (unsigned long long n = 0; n < hands; n++)
+	{
+		for (int c = 0; c < CARDS_IN_A_HAND; c++) add_card(&deck, &hand);
+		count[hand._rating]++;
+
+		for (int c = CARDS_IN_A_HAND; c > 0; c--) drop_card(&deck, &hand, c);
+	}
+}
+
+
+
+int main(int argc, char *argv[])
+{
+	unsigned long long total = (argc > 1) ? strtoull(argv[1], NULL, 0) : N;
+	unsigned int       seed  = (argc > 2) ? (unsigned int)strtoul(argv[2], NULL, 0) : SEED;
+	if (total < 1 || argc > 3)
+	{
+		printf("\n    Usage: poker [N [seed]], N >= 1\n\n");
+		return 1;
+	}
+
+	unsigned long long count[HANDEVAL_CATEGORIES] = {0}, exact[HANDEVAL_CATEGORIES];
 	double observed[10] = {0};
-	double expected[10] = {0.501177394, 0.422569027, 0.047539015, 0.021128451, 0.003924646, 0.001965401, 0.001440576, 0.000240096, 0.000013851, 0.000001539};
+	double expected[10] = {0};
 	
 	char *labels[11] = {"hand", "High Card", "One Pair", "Two Pair", "Three of a kind", "Straight", "Flush", 
 	                    "Full house", "Four of a kind", "Straight flush", "Royal flush"};
 	
-	Deck *deck = new_deck();	
-	Hand *hand = new_hand();
-	
-		//  play N poker hands and record frequency of each type of hand.
-	for (int n = 0; n < N; n++)
-	{		
-		for (int c = 0; c < CARDS_IN_A_HAND; c++) add_card(deck, hand);		
-		observed[hand -> _rating]++;
-		
-		for (int c = 0; c < CARDS_IN_A_HAND; c++) drop_card(deck, hand, 1);		
+		//  count all C(52, 5) hands of each kind, so the expected frequencies are exact
+	if (combos_count(exact, HANDEVAL_CATEGORIES, 52, CARDS_IN_A_HAND, handeval_batch) != 0)
+	{
+		printf("\n    Unable to allocate memory.\n\n");
+		return 1;
+	}
+
+	if ((double)total * CARDS_IN_A_HAND > 2147483648.0) printf("\n    Note: the hands take more than the period of the generator and repeat.\n");
+
+		//  play the hands in chunks on all cores, each thread counting in its own histogram
+	long long chunks = (long long)((total + CHUNK - 1) / CHUNK);
+
+#pragma omp parallel
+	{
+		unsigned long long local[HANDEVAL_CATEGORIES] = {0};
+
+#pragma omp for schedule(dynamic)
+		for (long long k = 0; k < chunks; k++)
+		{
+			unsigned long long first = (unsigned long long)k * CHUNK;
+			play(local, first, (total - first < CHUNK) ? total - first : CHUNK, seed);
+		}
+
+			//  merge the histograms
+#pragma omp critical
+		for (int c = 0; c < HANDEVAL_CATEGORIES; c++) count[c] += local[c];
 	}
 	
-		//  prepare the array of expected frequencies.
-	for (int c = 0; c < 10; c++) expected[c] *= N;
+		//  prepare the arrays of observed and expected frequencies.
+	for (int c = 0; c < 10; c++)
+	{
+		observed[c] = (double)count[c];
+		expected[c] = (double)exact[c] * ((double)total / (double)combos_binomial(52, CARDS_IN_A_HAND));
+	}
 	
 		//  perform chi square goodnes of fit test.
 	statistics_csgof(observed, expected, 10, labels, 0.1);	
 	
-		//  not really necessary as the OS will free the memory at program termination.
-	destroy_hand(&hand);
-	destroy_deck(&deck);
-	
 	return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,344 @@
+/*
+ * bitruns.c
+ *
+ * Created: 18. Oct. 2026
+ *  Author: Frank Bjørnø
+ *
+ * Purpose:
+ *      Count binary runs in packed bits, 64 bits at a time.
+ *
+ * License:
+ *
+ *          Copyright (C) 2026 Frank Bjørnø
+ *
+ *          1. Permission is hereby granted, free of charge, to any person obtaining a copy
+ *          of this software and associated documentation files (the "Software"), to deal
+ *          in the Software without restriction, including without limitation the rights
+ *          to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ *          of the Software, and to permit persons to whom the Software is furnished to do
+ *          so, subject to the following conditions:
+ *
+ *          2. The above copyright notice and this permission notice shall be included in all
+ *          copies or substantial portions of the Software.
+ *
+ *          3. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *          INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ *          PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *          HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ *          CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ *          OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <math.h>
+
+#include "bitruns.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+#if defined(_MSC_VER) && defined(__AVX2__)
+#include <intrin.h>
+#endif
+
+#define _LANES   4						//  interleaved histograms of the run counts
+
+
+
+/*
+ *     Count the bits that are set in a 64 bit word.
+ *
+ *     Note:  The popcnt instruction is only used when compiled for AVX2, since older
+ *            processors may not have it.
+ */
+static unsigned int _popcount(uint64_t x)
+{
+#if defined(_MSC_VER) && defined(__AVX2__) && defined(_M_X64)
+	return (unsigned int)__popcnt64(x);
+#elif defined(_MSC_VER) && defined(__AVX2__)
+	return __popcnt((unsigned int)x) + __popcnt((unsigned int)(x >> 32));
+#elif defined(__GNUC__)
+	return (unsigned int)__builtin_popcountll(x);
+#else
+	x = x - ((x >> 1) & 0x5555555555555555ULL);
+	x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+	x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+	return (unsigned int)((x * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+
+
+/*
+ *     Code numbers as bits, 1 if a number is above a threshold, 0 if not.
+ *
+ *     \param *bits       Receives BITRUNS_WORDS(n) words. Number c is bit c % 64 of word
+ *                        c / 64, lsb first, and the bits after the last number are 0.
+ *     \param *x          The numbers, less than 2^31.
+ *     \param  n          Number of numbers.
+ *     \param  threshold  Numbers above this are coded as 1, less than 2^31. rndmax() / 2
+ *                        codes the numbers from rnd() the same way as comparing them to the
+ *                        mean rndmax() / 2.0.
+ *
+ *     Note:  With AVX2, eight numbers are compared at a time and the results collected with
+ *            movemask, with AVX-512 sixteen. The numbers are below 2^31, so a signed compare
+ *            gives the right answer.
+ */
+void bitruns_pack(uint64_t *bits, const unsigned int *x, size_t n, unsigned int threshold)
+{
+	size_t c = 0, k = 0;
+
+#if defined(__AVX512F__)
+	__m512i t16 = _mm512_set1_epi32((int)threshold);
+	for (; c + 64 <= n; c += 64, k++)
+	{
+		uint64_t word = 0;
+		for (int j = 0; j < 4; j++)
+		{
+			__m512i v = _mm512_loadu_si512((const void *)(x + c + 16 * j));
+			word |= (uint64_t)_mm512_cmpgt_epi32_mask(v, t16) << (16 * j);
+		}
+		bits[k] = word;
+	}
+#elif defined(__AVX2__)
+	__m256i t8 = _mm256_set1_epi32((int)threshold);
+	for (; c + 64 <= n; c += 64, k++)
+	{
+		uint64_t word = 0;
+		for (int j = 0; j < 8; j++)
+		{
+			__m256i v = _mm256_loadu_si256((const __m256i *)(x + c + 8 * j));
+			word |= (uint64_t)(unsigned int)_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(v, t8))) << (8 * j);
+		}
+		bits[k] = word;
+	}
+#endif
+
+	for (; c < n; c += 64, k++)
+	{
+		uint64_t word = 0;
+		for (size_t j = 0; j < 64 && c + j < n; j++) word |= (uint64_t)(x[c + j] > threshold) << j;
+		bits[k] = word;
+	}
+}
+
+
+
+/*
+ *     Count the binary runs in a word.
+ *
+ *     \param  word   The word, in the lowest w bits. Higher bits are ignored.
+ *     \param  w      Number of bits in the word, 1 - 64.
+ *
+ *     \return        The number of binary runs, 1 - w.
+ *
+ *     Note:  Every bit that differs from the next one ends a run, so the runs are one more
+ *            than the set bits of word ^ (word >> 1), leaving out the top bit.
+ */
+unsigned int bitruns_runs(uint64_t word, int w)
+{
+	uint64_t mask = (w == 64) ? 0x7fffffffffffffffULL : (1ULL << (w - 1)) - 1;
+	return 1 + _popcount((word ^ (word >> 1)) & mask);
+}
+
+
+
+/*
+ *     Compute the binomial coefficients C(n, k), k = 0, 1, ..., n, as a row of Pascal's
+ *     triangle, with additions only, so no intermediate result is larger than the answer.
+ *
+ *     \param *row    Array of n + 1 coefficients.
+ *     \param  n      0 - 63.
+ */
+static void _binomials(unsigned long long *row, int n)
+{
+	row[0] = 1;
+	for (int i = 1; i <= n; i++)
+	{
+		row[i] = 1;
+		for (int k = i - 1; k > 0; k--) row[k] += row[k - 1];
+	}
+}
+
+
+
+/*
+ *     Count the words of w bits with r runs.
+ *
+ *     \param  w      Number of bits in a word, 1 - 64.
+ *     \param  r      Number of runs.
+ *
+ *     \return        2 * C(w - 1, r - 1), exactly, or 0 if r is not in 1 - w.
+ *
+ *     Note:  A word with r runs is given by its first bit and by which r - 1 of the w - 1
+ *            gaps between neighbouring bits start a new run. The largest count, for w = 64,
+ *            is 2 * C(63, 31) < 2^61, so it fits in 64 bits.
+ */
+unsigned long long bitruns_ways(int w, int r)
+{
+	unsigned long long row[64];
+	if (r < 1 || r > w) return 0;
+	_binomials(row, w - 1);
+	return 2 * row[r - 1];
+}
+
+
+
+/*
+ *     Compute the expected number of words with 1, 2, ..., w runs.
+ *
+ *     \param *expected  Array of w entries, expected[r - 1] receives the expected number of
+ *                       words with r runs.
+ *     \param  w         Number of bits in a word, 1 - 64.
+ *     \param  words     Number of words.
+ *
+ *     Note:  The probability of r runs is 2 * C(w - 1, r - 1) / 2^w. This replaces counting
+ *            the runs of all 2^w words, which is only possible for small w.
+ */
+void bitruns_expected(double *expected, int w, unsigned long long words)
+{
+	unsigned long long row[64];
+	_binomials(row, w - 1);
+	for (int r = 1; r <= w; r++) expected[r - 1] = ldexp((double)row[r - 1], 1 - w) * (double)words;
+}
+
+
+
+/*
+ *     Histogram the runs in consecutive words of w bits.
+ *
+ *     \param *hist   Array of w counts, hist[r - 1] is increased by the number of words
+ *                    with r runs.
+ *     \param *bits   The packed bits.
+ *     \param  nbits  Number of bits. The bits after the last whole word are ignored.
+ *     \param  w      Number of bits in a word, 1 - 64.
+ *
+ *     Note:  Words do not have to start on a 64 bit boundary, a word that straddles two
+ *            64 bit words is put together from both.
+ */
+void bitruns_words(unsigned long long *hist, const uint64_t *bits, size_t nbits, int w)
+{
+	unsigned long long lane[_LANES][64] = {{0}};
+	uint64_t mask = (w == 64) ? ~0ULL : (1ULL << w) - 1;
+	size_t   words = nbits / w, k = 0;
+
+	if (64 % w == 0)
+	{
+			//  whole words in every 64 bit word, one lane each in turn
+		int per = 64 / w, l = 0;
+		for (size_t i = 0; k + per <= words; i++, k += per)
+		{
+			uint64_t b = bits[i];
+			for (int j = 0; j < per; j++, b = (w == 64) ? 0 : b >> w)
+			{
+				lane[l][bitruns_runs(b & mask, w) - 1]++;
+				l = (l + 1) & (_LANES - 1);
+			}
+		}
+	}
+	for (; k < words; k++)
+	{
+		size_t   pos = k * w, i = pos / 64;
+		unsigned s   = pos % 64;
+		uint64_t b   = bits[i] >> s;
+		if (s + w > 64) b |= bits[i + 1] << (64 - s);
+		lane[k % _LANES][bitruns_runs(b & mask, w) - 1]++;
+	}
+
+	for (int r = 0; r < w; r++) hist[r] += lane[0][r] + lane[1][r] + lane[2][r] + lane[3][r];
+}
+
+
+
+/*
+ *     Count the runs in a stream of bits, which may be given a piece at a time.
+ *
+ *     \param *bits   The packed bits.
+ *     \param  nbits  Number of bits.
+ *     \param *last   The last bit of the previous piece, or -1 before the first piece.
+ *                    Receives the last bit of this piece.
+ *
+ *     \return        The number of runs that start in this piece. The sum over all pieces
+ *                    is the number of runs in the stream.
+ *
+ *     Note:  The bit after the end of each 64 bit word is carried in from the next word, so
+ *            runs that cross word boundaries are counted once.
+ */
+unsigned long long bitruns_stream(const uint64_t *bits, size_t nbits, int *last)
+{
+	if (nbits == 0) return 0;
+
+	size_t             words = BITRUNS_WORDS(nbits), i;
+	unsigned long long runs  = (*last < 0 || *last != (int)(bits[0] & 1));
+
+	for (i = 0; i + 1 < words; i++) runs += _popcount(bits[i] ^ ((bits[i] >> 1) | (bits[i + 1] << 63)));
+
+		//  the last word, without the bits after the end
+	unsigned int used = (unsigned int)(nbits - 64 * i);
+	runs += bitruns_runs(bits[i], used) - 1;
+
+	*last = (int)((bits[i] >> (used - 1)) & 1);
+	return runs;
+}
+
+
+
+/*
+ *     Prepare the summary of an empty stream.
+ */
+void bitruns_summary_init(RunsSummary *s)
+{
+	s -> _ones  = s -> _zeros = s -> _runs = 0;
+	s -> _first = s -> _last  = -1;
+}
+
+
+
+/*
+ *     Add a piece of bits to the end of the stream of a summary.
+ *
+ *     \param *s      Pointer to the summary.
+ *     \param *bits   The packed bits.
+ *     \param  nbits  Number of bits.
+ */
+void bitruns_summary_add(RunsSummary *s, const uint64_t *bits, size_t nbits)
+{
+	if (nbits == 0) return;
+
+	size_t             words = BITRUNS_WORDS(nbits), i;
+	unsigned long long ones  = 0;
+
+	for (i = 0; i + 1 < words; i++) ones += _popcount(bits[i]);
+	ones += _popcount((nbits % 64) ? bits[i] & ((1ULL << (nbits % 64)) - 1) : bits[i]);
+
+	if (s -> _first < 0) s -> _first = (int)(bits[0] & 1);
+	s -> _ones  += ones;
+	s -> _zeros += nbits - ones;
+	s -> _runs  += bitruns_stream(bits, nbits, &s -> _last);
+}
+
+
+
+/*
+ *     Merge the summary of the piece of a stream that follows the piece of another summary.
+ *
+ *     \param *s      Pointer to the summary of the first piece, receives the summary of both.
+ *     \param *next   Pointer to the summary of the next piece.
+ *
+ *     Note:  If the last bit of the first piece is the same as the first bit of the next, a
+ *            run crosses the boundary and was counted in both pieces.
+ */
+void bitruns_summary_merge(RunsSummary *s, const RunsSummary *next)
+{
+	if (next -> _first < 0) return;
+	if (s -> _first < 0)
+	{
+		*s = *next;
+		return;
+	}
+
+	s -> _runs  += next -> _runs - (s -> _last == next -> _first);
+	s -> _ones  += next -> _ones;
+	s -> _zeros += next -> _zeros;
+	s -> _last   = next -> _last;
+}
@@ -0,0 +1,62 @@
+/*
+ * bitruns.h
+ *
+ * Created: 18. Oct. 2026
+ *  Author: Frank Bjørnø
+ *
+ * Purpose:
+ *      Count binary runs in packed bits, 64 bits at a time.
+ *
+ * License:
+ *
+ *          Copyright (C) 2026 Frank Bjørnø
+ *
+ *          1. Permission is hereby granted, free of charge, to any person obtaining a copy
+ *          of this software and associated documentation files (the "Software"), to deal
+ *          in the Software without restriction, including without limitation the rights
+ *          to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ *          of the Software, and to permit persons to whom the Software is furnished to do
+ *          so, subject to the following conditions:
+ *
+ *          2. The above copyright notice and this permission notice shall be included in all
+ *          copies or substantial portions of the Software.
+ *
+ *          3. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *          INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ *          PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *          HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ *          CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ *          OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define BITRUNS_WORDS(n)   (((n) + 63) / 64)				//  64 bit words needed for n bits
+
+
+/*
+ *     Summary of a stream of bits for the Wald-Wolfowitz runs test
+ *     The summaries of consecutive pieces of a stream can be merged into the summary of the
+ *     whole stream, so the pieces can be counted in parallel.
+ */
+typedef struct
+{
+	unsigned long long _ones, _zeros;
+	unsigned long long _runs;
+	int                _first, _last;				//  first and last bit, -1 if no bits yet
+} RunsSummary;
+
+void               bitruns_pack(uint64_t *bits, const unsigned int *x, size_t n, unsigned int threshold);
+unsigned int       bitruns_runs(uint64_t word, int w);
+unsigned long long bitruns_ways(int w, int r);
+void               bitruns_expected(double *expected, int w, unsigned long long words);
+void               bitruns_words(unsigned long long *hist, const uint64_t *bits, size_t nbits, int w);
+unsigned long long bitruns_stream(const uint64_t *bits, size_t nbits, int *last);
+
+void               bitruns_summary_init(RunsSummary *s);
+void               bitruns_summary_add(RunsSummary *s, const uint64_t *bits, size_t nbits);
+void               bitruns_summary_merge(RunsSummary *s, const RunsSummary *next);
@@ -7,6 +7,12 @@
  * Purpose: 
  *      To test for randomness in a sequence of numbers using the chi square goodness of fit test.
  *
+ * Usage:
+ *      chiruns [sequences [width]]
+ *
+ *      sequences is the number of sequences, 65536 by default, and width the number of
+ *      bits in a sequence, 2 - 64, 16 by default.
+ *
  * Compilation:
  *     From the command line with Microsoft (R) Macro Assembler and 
  *                                Microsoft (R) C/C++ Optimizing Compiler.
@@ -14,7 +20,7 @@
  *      1. Assemble rng.asm without linking using the command
  *         ml /c rng.asm
  *      2. Compile and link the program using the command
- *         cl chiruns.c statistics.c rng.obj
+ *         cl /O2 chiruns.c bitruns.c statistics.c rng.obj
  *
  * License:
  * 
@@ -40,14 +46,19 @@
 
 
 
+#include <stdio.h>
+#include <stdlib.h>
 #include <stdint.h>
-#include <math.h>
 
+#include "bitruns.h"
 #include "statistics.h"
 
 
 #define N          65536
-#define BUFFERSIZE    16
+#define WIDTH         16						//  default number of bits in a sequence
+#define MAXWIDTH      64
+#define MINEXPECTED  5.0						//  rarer numbers of runs are counted with their neighbours
+#define BLOCK      (1 << 16)					//  sequences generated at a time
 
 
 extern         void randomize(void);
@@ -55,86 +66,71 @@ extern unsigned int rndmax();
 extern unsigned int rnd();
 
 
-/*
- *     get_sequence() uses this value to decide if a number is above or below the mean.
- *     This variable must be set in the main function
- */
-static double mean = 0;
-
-
 
-/*
- *     This generates 16 random numbers and codes a 16 bit unsigned integer, lsb to msb, based on the generated
- *     numbers. If a number below the mean is generated a 0 is coded, if a number above the mean is generated
- *     a 1 is coded.
- *
- *     Note: the static varable mean must be set before calling this functon.
- */
-uint16_t get_sequence()
-{
-	uint16_t sequence = 0x00;	
-	for (uint16_t mask = 0x01; mask > 0x00; mask <<= 1) sequence |= mask * (rnd() > mean);
-	return sequence;
-}
-
-
-
-/*
- *     This function counts the number of binary runs in a 16 bit number.
- *
- *     \param data     The 16 bit number to be analyzed.
- *
- *     \return         The number of binary runs.
- *
- *     Example:  The binary representation of the number 28024 is 0110 1101 0111 1000.
- *               In binary, evaluated from left to right(lsb to msb) the numnber starts 
- *               with a run of three zeros, followed by a run of four ones. Then three 
- *               single digit runs etc. for a total of nine runs.
- */
-uint8_t runs(uint16_t data)
+int main(int argc, char *argv[])
 {
-	uint8_t bitvalue;
-	uint8_t current = 2;					//  initialize to "impossible" value.
-	uint8_t runs    = 0;
-	
-	/*
-	 *  Test each bit of data from least significant to most. 
-	 *  The loop condition fails when the mask bit is shifted out
-	 *  of mask and mask becomes 0.
-	 */
-	for (uint16_t mask = 0x01; mask > 0x00; mask <<= 1)
+	unsigned long long sequences = (argc > 1) ? strtoull(argv[1], NULL, 0) : N;
+	int                width     = (argc > 2) ? atoi(argv[2]) : WIDTH;
+	if (sequences == 0 || width < 2 || width > MAXWIDTH || argc > 3)
 	{
-		bitvalue = (mask & data) != 0;	//  test bit			
-		
-		if (bitvalue != current)			//  guaranteed to evaluate to true on the first iteration.
-		{
-			runs++;
-			current = bitvalue;
-		}
+		printf("\n    Usage: chiruns [sequences [width]], sequences > 0, 2 <= width <= 64\n\n");
+		return 1;
 	}
-	return runs;
-}
-
 
-
-int main(void)
-{
 	randomize();
-	mean = rndmax() / 2.0;
+	unsigned int threshold = rndmax() / 2;				//  rnd() > threshold is the same as rnd() > rndmax() / 2.0
+
+	unsigned int      *x    = (unsigned int *)malloc(width * (size_t)BLOCK * sizeof(unsigned int));
+	uint64_t          *bits = (uint64_t *)malloc(BITRUNS_WORDS(width * (size_t)BLOCK) * sizeof(uint64_t));
+	unsigned long long count[MAXWIDTH] = {0};
+	if (x == NULL || bits == NULL)
+	{
+		printf("\n    Unable to allocate memory.\n\n");
+		return 1;
+	}
+	
+	double  observed[MAXWIDTH] = {0};
+	double  expected[MAXWIDTH] = {0};
+	  char  text[MAXWIDTH][8];
+	  char *labels[MAXWIDTH + 1] = {"runs"};
 	
-	double  observed[BUFFERSIZE] = {0};
-	double  expected[BUFFERSIZE] = {0};
-	  char *labels[BUFFERSIZE + 1] = {"runs", " 1", " 2", " 3", " 4", " 5", " 6", " 7", " 8", " 9", "10", "11", "12", "13", "14", "15", "16"};
+		//  fill expected, 2 * C(width - 1, r - 1) of the 2^width sequences have r runs
+	bitruns_expected(expected, width, sequences);
 	
-		//  fill expected
-	for (int c = 0; c < N; c++) expected[runs(c) - 1]++;		
+		//  fill observed, coding width numbers at a time as the bits of a sequence, lsb first
+	for (unsigned long long done = 0; done < sequences; done += BLOCK)
+	{
+		size_t n = width * (size_t)((sequences - done < BLOCK) ? sequences - done : BLOCK);
+		for (size_t c = 0; c < n; c++) x[c] = rnd();
+		bitruns_pack(bits, x, n, threshold);
+		bitruns_words(count, bits, n, width);
+	}
+	for (int r = 0; r < width; r++) observed[r] = (double)count[r];
 	
-		//  fill observed
-	for (int c = 0; c < N; c++) observed[runs(get_sequence()) - 1]++;		
+		//  count the rare numbers of runs at both ends with their neighbours
+	int first = 0, last = width - 1;
+	while (first < last && expected[first] < MINEXPECTED)
+	{
+		expected[first + 1] += expected[first], observed[first + 1] += observed[first];
+		first++;
+	}
+	while (last > first && expected[last] < MINEXPECTED)
+	{
+		expected[last - 1] += expected[last], observed[last - 1] += observed[last];
+		last--;
+	}
+	for (int r = first; r <= last; r++)
+	{
+		if (r == first && first > 0)          sprintf(text[r], "<=%d", r + 1);
+		else if (r == last && last < width - 1) sprintf(text[r], ">=%d", r + 1);
+		else                                  sprintf(text[r], "%2d", r + 1);
+		labels[r - first + 1] = text[r];
+	}
 	
 		//  perform test
-	statistics_csgof(observed, expected, BUFFERSIZE, labels, 0.1);	
+	statistics_csgof(observed + first, expected + first, last - first + 1, labels, 0.1);	
 	
+	free(bits);
+	free(x);
 	return 0;
 }
-
@@ -31,32 +31,13 @@
 
 
 
-fmt = '%u';
-DATA = [];
-sizeDATA = [1, inf];
-
 %  --------------------------    Read Data    --------------------------
 
-	%  'data_file.dat' should be in the same directory as this MatLab file
+	%  'datafile.dat' should be in the same directory as this MatLab file, and so
+	%  should read_dataset.m from the Dataset folder.
 	%  Both runs_obs.c and runs_exp.c overwrites and stores data in 'datafile.dat' so
 	%  this script generates a histogram based on which of these files was run last.
-fileID = fopen('datafile.dat', 'r');
-
-if (fileID == -1)
-    disp('Error: Could not open data file.')
-else
-    while ~feof(fileID)
-        DATA = fscanf(fileID, fmt, sizeDATA);        
-    end
-    
-    closeresult = fclose(fileID);
-    if closeresult ~= 0
-        disp('Error: Could not close file.')
-    end
-end
-
-	% clean up
-clear closeresult fileID fmt sizeDATA
+[DATA, INFO] = read_dataset('datafile.dat');
 
 
 %  --------     prepare data for the overlaying normal curve    --------
@@ -13,7 +13,7 @@
  *                                Microsoft (R) C/C++ Optimizing Compiler.
  * 
  *      1. Compile and link the program using the command
- *         cl runs_exp.c
+ *         cl runs_exp.c bitruns.c dataset.c
  *
  * License:
  * 
@@ -42,58 +42,26 @@
 #include <stdio.h>
 #include <stdint.h>
 
-#define N 65536
-
+#include "bitruns.h"
+#include "dataset.h"
 
-
-/*
- *     This function counts the number of binary runs in a 16 bit number.
- *
- *     \param data     The 16 bit number to be analyzed.
- *
- *     \return         The number of binary runs.
- *
- *     Example:  The binary representation of the number 28024 is 0110 1101 0111 1000.
- *               In binary, evaluated from left to right(lsb to msb) the numnber starts 
- *               with a run of three zeros, followed by a run of four ones. Then three 
- *               single digit runs etc. for a total of nine runs.
- */
-uint8_t runs(uint16_t data)
-{
-	uint8_t bitvalue;
-	uint8_t current = 2;					//  initialize to "impossible" value.
-	uint8_t runs    = 0;
-	
-	/*
-	 *  Test each bit of data from least significant to most. 
-	 *  The loop condition fails when the mask bit is shifted out
-	 *  of mask and mask becomes 0.
-	 */
-	for (uint16_t mask = 0x01; mask > 0x00; mask <<= 1)
-	{
-		bitvalue = (mask & data) != 0;	//  test bit			
-		
-		if (bitvalue != current)			//  guaranteed to evaluate to true on the first iteration.
-		{
-			runs++;
-			current = bitvalue;
-		}
-	}
-	return runs;
-}
+#define N 65536
 
 
 
 int main(void)
 {	
-		
-	char *format = "%u\n";
-	FILE *fp;
-	fp = fopen("datafile.dat", "w");
+	static unsigned char runs[N];
+	DatasetWriter w;
 	
-		//  count binary runs of every number from 0 to 65535 and store results.
-	for (int c = 0; c < N; c++) fprintf(fp, format, runs(c));	
-	fclose(fp);
+		//  count binary runs of every number from 0 to 65535 and store results, one byte each.
+		//  the numbers are not random, so the seed is 0.
+	for (int c = 0; c < N; c++) runs[c] = (unsigned char)bitruns_runs(c, 16);
+	if (dataset_create(&w, "datafile.dat", DS_U8, 1, 0) != 0 || dataset_write(&w, runs, N) != 0 || dataset_close(&w) != 0)
+	{
+		printf("\n    Unable to write datafile.dat.\n\n");
+		return 1;
+	}
 	
 	return 0;
 }
@@ -14,7 +14,7 @@
  * 
  *      1. Compile and link the program using the commands
  *         ml /c rng.asm
- *         cl runs_obs.c rng.obj
+ *         cl runs_obs.c bitruns.c dataset.c rng.obj
  *
  * License:
  * 
@@ -43,80 +43,37 @@
 #include <stdio.h>
 #include <stdint.h>
 
+#include "bitruns.h"
+#include "dataset.h"
+
 #define N 65536
 
-extern         void randomize(void);
+extern unsigned int randomize(void);
 extern unsigned int rndmax();
 extern unsigned int rnd();
 
-static double mean = 0;
-
 
 
-/*
- *     This generates 16 random numbers and codes a 16 bit unsigned integer, lsb to msb, based on the generated
- *     numbers. If a number below the mean is generated a 0 is coded, if a number above the mean is generated
- *     a 1 is coded.
- *
- *     Note: the static varable mean must be set before calling this functon.
- */
-uint16_t get_sequence()
+int main(void)
 {
-	uint16_t sequence = 0x00;	
-	for (uint16_t mask = 0x01; mask > 0x00; mask <<= 1) sequence |= mask * (rnd() > mean);
-	return sequence;
-}
-
+	static unsigned int x[16 * N];
+	static uint64_t     bits[BITRUNS_WORDS(16 * N)];
 
-/*
- *     This function counts the number of binary runs in a 16 bit number.
- *
- *     \param data     The 16 bit number to be analyzed.
- *
- *     \return         The number of binary runs.
- *
- *     Example:  The binary representation of the number 28024 is 0110 1101 0111 1000.
- *               In binary, evaluated from left to right(lsb to msb) the numnber starts 
- *               with a run of three zeros, followed by a run of four ones. Then three 
- *               single digit runs etc. for a total of nine runs.
- */
-uint8_t runs(uint16_t data)
-{
-	uint8_t bitvalue;
-	uint8_t current = 2;					//  initialize to "impossible" value.
-	uint8_t runs    = 0;
+	unsigned int seed = randomize();				//  randomize returns the new seed in EAX
+	for (int c = 0; c < 16 * N; c++) x[c] = rnd();
 	
-	/*
-	 *  Test each bit of data from least significant to most. 
-	 *  The loop condition fails when the mask bit is shifted out
-	 *  of mask and mask becomes 0.
-	 */
-	for (uint16_t mask = 0x01; mask > 0x00; mask <<= 1)
+		//  code the numbers as bits, 1 above the mean rndmax() / 2.0 and 0 below, 16 bits to a sequence
+	bitruns_pack(bits, x, 16 * N, rndmax() / 2);
+	
+		//  count binary runs of 65536 random numbers and store results, one byte each.
+	static unsigned char runs[N];
+	DatasetWriter w;
+	for (int c = 0; c < N; c++) runs[c] = (unsigned char)bitruns_runs(bits[c / 4] >> (16 * (c % 4)) & 0xffff, 16);
+	if (dataset_create(&w, "datafile.dat", DS_U8, 1, seed) != 0 || dataset_write(&w, runs, N) != 0 || dataset_close(&w) != 0)
 	{
-		bitvalue = (mask & data) != 0;	//  test bit			
-		
-		if (bitvalue != current)			//  guaranteed to evaluate to true on the first iteration.
-		{
-			runs++;
-			current = bitvalue;
-		}
+		printf("\n    Unable to write datafile.dat.\n\n");
+		return 1;
 	}
-	return runs;
-}
-
-
-int main(void)
-{
-	randomize();
-	mean = rndmax() / 2.0;
-	
-	char *format = "%u\n";
-	FILE *fp;
-	fp = fopen("datafile.dat", "w");
-	
-		//  count binary runs of 65536 random numbers and store results.
-	for (int c = 0; c < N; c++) fprintf(fp, format, runs(get_sequence()));
-	fclose(fp);
 
 	return 0;
 }
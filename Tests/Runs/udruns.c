@@ -0,0 +1,148 @@
+/*
+ * udruns.c
+ *
+ * Created: 18. Oct. 2026
+ *  Author: Frank Bjørnø
+ *
+ * Purpose:
+ *      To test for randomness in a sequence of numbers using Knuth's runs up and runs down
+ *      tests, which look at the lengths of monotone runs rather than runs above and below
+ *      the mean.
+ *
+ * Usage:
+ *      udruns [n [seed]]
+ *
+ *      n is the number of values in the sequence, 10^9 by default, at least 4000.
+ *
+ * Compilation:
+ *     From the command line with Microsoft (R) C/C++ Optimizing Compiler.
+ *
+ *      1. Compile and link the program using the command
+ *         cl /O2 /arch:AVX2 /openmp udruns.c updown.c generator.c statistics.c
+ *
+ * License:
+ *
+ *          Copyright (C) 2026 Frank Bjørnø
+ *
+ *          1. Permission is hereby granted, free of charge, to any person obtaining a copy
+ *          of this software and associated documentation files (the "Software"), to deal
+ *          in the Software without restriction, including without limitation the rights
+ *          to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ *          of the Software, and to permit persons to whom the Software is furnished to do
+ *          so, subject to the following conditions:
+ *
+ *          2. The above copyright notice and this permission notice shall be included in all
+ *          copies or substantial portions of the Software.
+ *
+ *          3. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *          INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ *          PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *          HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ *          CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ *          OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "updown.h"
+#include "generator.h"
+#include "statistics.h"
+
+
+#define N          1000000000ULL				//  default number of values
+#define SEED       0x13b3e					//  the initial seed of rng.asm
+#define CHUNK      (1 << 20)					//  values in a chunk, the unit of parallel work
+#define BLOCK      4096						//  values generated at a time
+#define ALPHA       0.05
+
+
+
+/*
+ *     Summarize the runs up and the runs down of one chunk of the sequence, from its own
+ *     position in the stream.
+ */
+static void summarize(UpDown *up, UpDown *down, unsigned long long first, unsigned long long count, unsigned int seed)
+{
+	unsigned int x[BLOCK];
+	Generator    g;
+
+	generator_init(&g, seed);
+	generator_jump(&g, first);
+	updown_init(up, 0);
+	updown_init(down, 1);
+
+	for (unsigned long long done = 0; done < count; done += BLOCK)
+	{
+		size_t m = (count - done < BLOCK) ? (size_t)(count - done) : BLOCK;
+		generator_fill(&g, x, m);
+		updown_add(up, x, m);
+		updown_add(down, x, m);
+	}
+}
+
+
+
+int main(int argc, char *argv[])
+{
+	unsigned long long total = (argc > 1) ? strtoull(argv[1], NULL, 0) : N;
+	unsigned int       seed  = (argc > 2) ? (unsigned int)strtoul(argv[2], NULL, 0) : SEED;
+	if (total < 4000 || argc > 3)
+	{
+		printf("\n    Usage: udruns [n [seed]], n >= 4000\n\n");
+		return 1;
+	}
+
+		//  count the runs of every chunk in parallel, and stitch the chunks together
+	long long chunks = (long long)((total + CHUNK - 1) / CHUNK);
+	UpDown   *part   = (UpDown *)malloc(2 * chunks * sizeof(UpDown));
+	UpDown    all[2];
+	if (part == NULL)
+	{
+		printf("\n    Unable to allocate memory.\n\n");
+		return 1;
+	}
+
+#pragma omp parallel for schedule(dynamic)
+	for (long long k = 0; k < chunks; k++)
+	{
+		unsigned long long first = (unsigned long long)k * CHUNK;
+		summarize(&part[2 * k], &part[2 * k + 1], first, (total - first < CHUNK) ? total - first : CHUNK, seed);
+	}
+
+	updown_init(&all[0], 0);
+	updown_init(&all[1], 1);
+	for (long long k = 0; k < chunks; k++)
+	{
+		updown_merge(&all[0], &part[2 * k]);
+		updown_merge(&all[1], &part[2 * k + 1]);
+	}
+	free(part);
+
+		//  present analysis
+	const char *name[2] = {"up", "down"};
+	printf("\n\n\n               Runs up and runs down test, %llu values.\n\n", total);
+	printf("    H0: The lengths of the monotone runs indicate randomness.\n");
+	printf("    HA: The lengths of the monotone runs indicate non-randomness.\n\n");
+	printf("    Alpha: %4.2f\n\n", ALPHA);
+
+	for (int d = 0; d < 2; d++)
+	{
+		unsigned long long count[UPDOWN_LENGTHS];
+		double             V = updown_v(&all[d]), P = statistics_pchisq(V, UPDOWN_LENGTHS);
+
+		updown_counts(&all[d], count);
+		printf("    runs %-4s      observed        expected\n", name[d]);
+		puts("    --------------------------------------------");
+		for (int i = 0; i < UPDOWN_LENGTHS; i++)
+		{
+			printf("    %s%d   %14llu %17.2f\n", (i == UPDOWN_LENGTHS - 1) ? ">=" : "  ", i + 1,
+			       count[i], updown_expected(i + 1) * total);
+		}
+		puts("    --------------------------------------------");
+		printf("    V = %.4f, df = %d, P = %.4f, reject H0 (P < Alpha)? %s\n\n", V, UPDOWN_LENGTHS, P, (P < ALPHA) ? "YES" : "NO");
+	}
+
+	return 0;
+}
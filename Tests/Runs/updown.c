@@ -0,0 +1,306 @@
+/*
+ * updown.c
+ *
+ * Created: 18. Oct. 2026
+ *  Author: Frank Bjørnø
+ *
+ * Purpose:
+ *      Knuth's runs up and runs down test, counting the lengths of monotone runs in long
+ *      sequences a piece at a time.
+ *
+ * License:
+ *
+ *          Copyright (C) 2026 Frank Bjørnø
+ *
+ *          1. Permission is hereby granted, free of charge, to any person obtaining a copy
+ *          of this software and associated documentation files (the "Software"), to deal
+ *          in the Software without restriction, including without limitation the rights
+ *          to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ *          of the Software, and to permit persons to whom the Software is furnished to do
+ *          so, subject to the following conditions:
+ *
+ *          2. The above copyright notice and this permission notice shall be included in all
+ *          copies or substantial portions of the Software.
+ *
+ *          3. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *          INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ *          PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *          HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ *          CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ *          OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <stdint.h>
+
+#include "updown.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+
+/*
+ *     The inverse of the covariance matrix of the counts of runs of length 1, ..., 5 and
+ *     6 or more, and the probabilities b_i, from Knuth, The Art of Computer Programming,
+ *     Vol. 2, 3.3.2 G. The matrix is given to the precision computed by Grafton (1981).
+ */
+static const double _a[UPDOWN_LENGTHS][UPDOWN_LENGTHS] =
+{
+	{ 4529.35365,  9044.90208, 13567.9452,  18091.2672,  22614.7139,  27892.1588},
+	{ 9044.90208, 18097.0254,  27139.4552,  36186.6493,  45233.8198,  55788.8311},
+	{13567.9452,  27139.4552,  40721.3320,  54281.2656,  67852.0446,  83684.5705},
+	{18091.2672,  36186.6493,  54281.2656,  72413.6012,  90470.0914, 111580.1320},
+	{22614.7139,  45233.8198,  67852.0446,  90470.0914, 113261.9740, 139475.7400},
+	{27892.1588,  55788.8311,  83684.5705, 111580.1320, 139475.7400, 172860.1710}
+};
+
+static const double _b[UPDOWN_LENGTHS] = {1.0 / 6.0, 5.0 / 24.0, 11.0 / 120.0, 19.0 / 720.0, 29.0 / 5040.0, 1.0 / 840.0};
+
+
+
+/*
+ *     Index of the lowest set bit of a nonzero 64 bit word.
+ */
+static unsigned int _ctz(uint64_t x)
+{
+#if defined(_MSC_VER) && defined(_M_X64)
+	unsigned long i;
+	_BitScanForward64(&i, x);
+	return (unsigned int)i;
+#elif defined(_MSC_VER)
+	unsigned long i;
+	if ((unsigned int)x) _BitScanForward(&i, (unsigned int)x);
+	else _BitScanForward(&i, (unsigned int)(x >> 32)), i += 32;
+	return (unsigned int)i;
+#elif defined(__GNUC__)
+	return (unsigned int)__builtin_ctzll(x);
+#else
+	unsigned int i = 0;
+	while (!(x & 1)) x >>= 1, i++;
+	return i;
+#endif
+}
+
+
+
+/*
+ *     Find where new runs start among count values.
+ *
+ *     \param *x      The values. x[-1] must be valid, it is compared to x[0].
+ *     \param  count  Number of values, at most 64.
+ *     \param  down   0 for runs up, 1 for runs down.
+ *
+ *     \return        Bit i is set if a new run starts at x[i], i.e. if x[i - 1] < x[i] does
+ *                    not hold for runs up, or x[i - 1] > x[i] for runs down.
+ *
+ *     Note:  With AVX2, eight neighbouring pairs are compared at a time by comparing the
+ *            values with the same values shifted by one. The values are below 2^31, so a
+ *            signed compare gives the right answer.
+ */
+static uint64_t _starts(const unsigned int *x, unsigned int count, int down)
+{
+	const unsigned int *prev = x - 1;
+	uint64_t            going = 0;
+	unsigned int        i = 0;
+
+#if defined(__AVX2__)
+	for (; i + 8 <= count; i += 8)
+	{
+		__m256i a = _mm256_loadu_si256((const __m256i *)(prev + i));
+		__m256i b = _mm256_loadu_si256((const __m256i *)(x + i));
+		__m256i c = down ? _mm256_cmpgt_epi32(a, b) : _mm256_cmpgt_epi32(b, a);
+		going |= (uint64_t)(unsigned int)_mm256_movemask_ps(_mm256_castsi256_ps(c)) << i;
+	}
+#endif
+	for (; i < count; i++) going |= (uint64_t)(down ? prev[i] > x[i] : prev[i] < x[i]) << i;
+
+	return ~going & ((count == 64) ? ~0ULL : (1ULL << count) - 1);
+}
+
+
+
+/*
+ *     Close the last run of a summary.
+ */
+static void _close(UpDown *s)
+{
+	if (s -> _head == 0) s -> _head = s -> _tail;
+	else s -> _count[(s -> _tail < UPDOWN_LENGTHS) ? s -> _tail - 1 : UPDOWN_LENGTHS - 1]++;
+}
+
+
+
+/*
+ *     Prepare the summary of an empty piece.
+ *
+ *     \param *s      Pointer to the summary.
+ *     \param  down   0 to count runs up, 1 to count runs down.
+ */
+void updown_init(UpDown *s, int down)
+{
+	for (int i = 0; i < UPDOWN_LENGTHS; i++) s -> _count[i] = 0;
+	s -> _n     = s -> _head = s -> _tail = 0;
+	s -> _first = s -> _last = 0;
+	s -> _down  = down;
+}
+
+
+
+/*
+ *     Add values to the end of the piece of a summary.
+ *
+ *     \param *s      Pointer to the summary.
+ *     \param *x      The values, less than 2^31.
+ *     \param  n      Number of values.
+ *
+ *     Note:  The values are taken 64 at a time, and the runs between the starts found by
+ *            _starts are counted without looking at the values again.
+ */
+void updown_add(UpDown *s, const unsigned int *x, size_t n)
+{
+	if (n == 0) return;
+
+	size_t p = 0;
+	if (s -> _n == 0)
+	{
+		s -> _first = x[0];
+		s -> _tail  = 1;
+		p = 1;
+	}
+	else if (s -> _down ? s -> _last > x[0] : s -> _last < x[0]) s -> _tail++, p = 1;
+	else
+	{
+		_close(s);
+		s -> _tail = 1;
+		p = 1;
+	}
+
+	for (; p < n; p += 64)
+	{
+		unsigned int count  = (n - p < 64) ? (unsigned int)(n - p) : 64, from = 0, b;
+		uint64_t     starts = _starts(x + p, count, s -> _down);
+
+		for (; starts; starts &= starts - 1, from = b + 1)
+		{
+			b = _ctz(starts);
+			s -> _tail += b - from;
+			_close(s);
+			s -> _tail = 1;
+		}
+		s -> _tail += count - from;
+	}
+
+	s -> _n   += n;
+	s -> _last = x[n - 1];
+}
+
+
+
+/*
+ *     Merge the summary of the piece that follows the piece of another summary.
+ *
+ *     \param *s      Pointer to the summary of the first piece, receives the summary of both.
+ *     \param *next   Pointer to the summary of the next piece, counting in the same direction.
+ *
+ *     Note:  If the last run of the first piece goes on into the next piece, it is joined
+ *            with the first run of the next piece, and the joined run is only counted once
+ *            it is closed.
+ */
+void updown_merge(UpDown *s, const UpDown *next)
+{
+	if (next -> _n == 0) return;
+	if (s -> _n == 0)
+	{
+		*s = *next;
+		return;
+	}
+
+	int goes_on = s -> _down ? s -> _last > next -> _first : s -> _last < next -> _first;
+
+	if (goes_on) s -> _tail += (next -> _head == 0) ? next -> _n : next -> _head;
+	else
+	{
+		_close(s);
+		s -> _tail = (next -> _head == 0) ? next -> _n : next -> _head;
+	}
+	if (next -> _head != 0)
+	{
+		_close(s);
+		s -> _tail = next -> _tail;
+	}
+
+	for (int i = 0; i < UPDOWN_LENGTHS; i++) s -> _count[i] += next -> _count[i];
+	s -> _n   += next -> _n;
+	s -> _last = next -> _last;
+}
+
+
+
+/*
+ *     Count the runs of the sequence of a summary, taken as a whole.
+ *
+ *     \param *s      Pointer to the summary.
+ *     \param *count  Array of UPDOWN_LENGTHS counts, receives the numbers of runs of length
+ *                    1, ..., 5 and 6 or more, including the first and the last run.
+ */
+void updown_counts(const UpDown *s, unsigned long long *count)
+{
+	UpDown t = *s;
+
+	if (t._n > 0)
+	{
+		_close(&t);							//  the last run
+		if (t._head != 0)
+		{
+			t._tail = t._head;					//  the first run
+			t._head = 1;
+			_close(&t);
+		}
+	}
+	for (int i = 0; i < UPDOWN_LENGTHS; i++) count[i] = t._count[i];
+}
+
+
+
+/*
+ *     Compute Knuth's statistic V of the runs in the sequence of a summary.
+ *
+ *     \param *s      Pointer to the summary.
+ *
+ *     \return        V = (C - nb)' A (C - nb) / (n - 6), where C are the counts, n the
+ *                    number of values and A the inverse covariance matrix. V has the chi
+ *                    square distribution with 6 degrees of freedom when n is large, at
+ *                    least about 4000.
+ *
+ *     Note:  The lengths of neighbouring runs are not independent, so the plain chi square
+ *            statistic of the counts does not have the chi square distribution.
+ */
+double updown_v(const UpDown *s)
+{
+	unsigned long long count[UPDOWN_LENGTHS];
+	double             d[UPDOWN_LENGTHS], n = (double)s -> _n, V = 0.0;
+
+	updown_counts(s, count);
+	for (int i = 0; i < UPDOWN_LENGTHS; i++) d[i] = (double)count[i] - n * _b[i];
+	for (int i = 0; i < UPDOWN_LENGTHS; i++)
+	{
+		for (int j = 0; j < UPDOWN_LENGTHS; j++) V += d[i] * d[j] * _a[i][j];
+	}
+	return V / (n - 6.0);
+}
+
+
+
+/*
+ *     The expected number of runs of a length per value, b_i.
+ *
+ *     \param  length   1, ..., 5, or 6 for runs of length 6 or more.
+ */
+double updown_expected(int length)
+{
+	return _b[length - 1];
+}
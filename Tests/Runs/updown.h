@@ -0,0 +1,61 @@
+/*
+ * updown.h
+ *
+ * Created: 18. Oct. 2026
+ *  Author: Frank Bjørnø
+ *
+ * Purpose:
+ *      Knuth's runs up and runs down test, counting the lengths of monotone runs in long
+ *      sequences a piece at a time.
+ *
+ * License:
+ *
+ *          Copyright (C) 2026 Frank Bjørnø
+ *
+ *          1. Permission is hereby granted, free of charge, to any person obtaining a copy
+ *          of this software and associated documentation files (the "Software"), to deal
+ *          in the Software without restriction, including without limitation the rights
+ *          to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ *          of the Software, and to permit persons to whom the Software is furnished to do
+ *          so, subject to the following conditions:
+ *
+ *          2. The above copyright notice and this permission notice shall be included in all
+ *          copies or substantial portions of the Software.
+ *
+ *          3. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *          INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ *          PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *          HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ *          CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ *          OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <stddef.h>
+
+#define UPDOWN_LENGTHS   6						//  runs of length 1, ..., 5 and 6 or more
+
+
+/*
+ *     Summary of the runs up or the runs down in a piece of a sequence
+ *     The runs that touch the ends of the piece may continue into the neighbouring pieces,
+ *     and are kept apart until the summaries of the pieces are merged.
+ */
+typedef struct
+{
+	unsigned long long _count[UPDOWN_LENGTHS];			//  runs inside the piece
+	unsigned long long _n;						//  number of values
+	unsigned long long _head;					//  length of the first run, 0 if the piece is one run
+	unsigned long long _tail;					//  length of the last run
+	unsigned int       _first, _last;				//  first and last value
+	int                _down;					//  0 for runs up, 1 for runs down
+} UpDown;
+
+void   updown_init(UpDown *s, int down);
+void   updown_add(UpDown *s, const unsigned int *x, size_t n);
+void   updown_merge(UpDown *s, const UpDown *next);
+void   updown_counts(const UpDown *s, unsigned long long *count);
+double updown_v(const UpDown *s);
+double updown_expected(int length);
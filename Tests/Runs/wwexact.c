@@ -0,0 +1,160 @@
+/*
+ * wwexact.c
+ *
+ * Created: 18. Oct. 2026
+ *  Author: Frank Bjørnø
+ *
+ * Purpose:
+ *      Exact p-values of the Wald-Wolfowitz runs test for short sequences, looked up in a
+ *      table computed once.
+ *
+ * License:
+ *
+ *          Copyright (C) 2026 Frank Bjørnø
+ *
+ *          1. Permission is hereby granted, free of charge, to any person obtaining a copy
+ *          of this software and associated documentation files (the "Software"), to deal
+ *          in the Software without restriction, including without limitation the rights
+ *          to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ *          of the Software, and to permit persons to whom the Software is furnished to do
+ *          so, subject to the following conditions:
+ *
+ *          2. The above copyright notice and this permission notice shall be included in all
+ *          copies or substantial portions of the Software.
+ *
+ *          3. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *          INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ *          PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *          HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ *          CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ *          OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <stdlib.h>
+
+#include "wwexact.h"
+
+
+
+/*
+ *     Position of the tail of r runs of m ones and n zeros in the table.
+ *
+ *     Note:  Only m <= n is stored, and for m >= 1 the numbers of runs 2, ..., 2m + 1, so the
+ *            rows of n before this one hold (n - 1)n(n + 1)/3 entries, and the pairs (1, n),
+ *            ..., (m - 1, n) before this one m(m - 1) entries.
+ */
+static size_t _index(size_t m, size_t n, size_t r)
+{
+	return (n - 1) * n * (n + 1) / 3 + m * (m - 1) + (r - 2);
+}
+
+
+
+/*
+ *     Compute the table of the tails of the distribution of the number of runs.
+ *
+ *     \param *t      Pointer to the table.
+ *     \param  bound  Largest number of ones or zeros, e.g. WWEXACT_BOUND. The table takes
+ *                    about 8 * bound^3 / 3 bytes, 45 MB for bound = 256.
+ *
+ *     \return        0 on success, 1 if memory could not be allocated.
+ *
+ *     Note:  Of the C(m + n, m) sequences, 2 * C(m - 1, k - 1) * C(n - 1, k - 1) have 2k runs,
+ *            and C(m - 1, k - 1) * C(n - 1, k) + C(m - 1, k) * C(n - 1, k - 1) have 2k + 1.
+ *            The binomial coefficients are taken from Pascal's triangle, computed by adding
+ *            the rows up to m + n = 2 * bound in doubles. The tails are summed from the
+ *            outside in, so even the smallest probabilities keep their precision.
+ */
+int wwexact_init(WWTable *t, int bound)
+{
+	size_t  B = (size_t)bound, rows = 2 * B + 1;
+	double *C = (double *)malloc(rows * rows * sizeof(double));
+	double *p = (double *)malloc((2 * B + 2) * sizeof(double));
+
+	t -> _bound = bound;
+	t -> _tail  = (double *)malloc((B * (B + 1) * (B + 2) / 3 + 1) * sizeof(double));
+	if (C == NULL || p == NULL || t -> _tail == NULL)
+	{
+		free(C), free(p), free(t -> _tail);
+		t -> _tail = NULL;
+		return 1;
+	}
+
+		//  Pascal's triangle, C[a * rows + b] = C(a, b)
+	for (size_t a = 0; a < rows; a++)
+	{
+		C[a * rows] = 1.0;
+		for (size_t b = 1; b <= a; b++) C[a * rows + b] = C[(a - 1) * rows + b - 1] + ((b < a) ? C[(a - 1) * rows + b] : 0.0);
+		for (size_t b = a + 1; b < rows; b++) C[a * rows + b] = 0.0;
+	}
+
+	for (size_t n = 1; n <= B; n++)
+	{
+		for (size_t m = 1; m <= n; m++)
+		{
+			const double *cm = C + (m - 1) * rows, *cn = C + (n - 1) * rows;
+			double        all = C[(m + n) * rows + m];
+			size_t        last = 2 * m + 1;
+
+				//  the distribution of the number of runs, 2 - 2m + 1
+			for (size_t k = 1; 2 * k <= last; k++)
+			{
+				p[2 * k] = 2.0 * cm[k - 1] * cn[k - 1] / all;
+				if (2 * k + 1 <= last) p[2 * k + 1] = (cm[k - 1] * cn[k] + ((k < m) ? cm[k] * cn[k - 1] : 0.0)) / all;
+			}
+
+				//  the smaller tail, lower tails from below and upper tails from above
+			double lower = 0.0, upper = 0.0;
+			for (size_t r = 2; r <= last; r++) t -> _tail[_index(m, n, r)] = (lower += p[r]);
+			for (size_t r = last; r >= 2; r--)
+			{
+				upper += p[r];
+				double *tail = &t -> _tail[_index(m, n, r)];
+				if (upper < *tail) *tail = upper;
+			}
+		}
+	}
+
+	free(C);
+	free(p);
+	return 0;
+}
+
+
+
+/*
+ *     Release the memory of a table.
+ */
+void wwexact_free(WWTable *t)
+{
+	free(t -> _tail);
+	t -> _tail = NULL;
+}
+
+
+
+/*
+ *     Look up the exact p-value of the Wald-Wolfowitz runs test.
+ *
+ *     \param *t      Pointer to the table.
+ *     \param  ones   Number of ones.
+ *     \param  zeros  Number of zeros.
+ *     \param  runs   Observed number of runs.
+ *
+ *     \return        The two tailed p-value, twice the probability of the smaller tail
+ *                    at the observed number of runs, at most 1. Returns -1.0 if there are
+ *                    more ones or zeros than the table covers, or if the number of runs is
+ *                    impossible.
+ */
+double wwexact_p(const WWTable *t, unsigned long long ones, unsigned long long zeros, unsigned long long runs)
+{
+	unsigned long long m = (ones < zeros) ? ones : zeros, n = (ones < zeros) ? zeros : ones;
+
+	if (n > (unsigned long long)t -> _bound) return -1.0;
+	if (m == 0) return (runs == (n > 0)) ? 1.0 : -1.0;
+	if (runs < 2 || runs > 2 * m + (m < n)) return -1.0;
+
+	double p = 2.0 * t -> _tail[_index((size_t)m, (size_t)n, (size_t)runs)];
+	return (p < 1.0) ? p : 1.0;
+}
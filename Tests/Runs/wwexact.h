@@ -0,0 +1,52 @@
+/*
+ * wwexact.h
+ *
+ * Created: 18. Oct. 2026
+ *  Author: Frank Bjørnø
+ *
+ * Purpose:
+ *      Exact p-values of the Wald-Wolfowitz runs test for short sequences, looked up in a
+ *      table computed once.
+ *
+ * License:
+ *
+ *          Copyright (C) 2026 Frank Bjørnø
+ *
+ *          1. Permission is hereby granted, free of charge, to any person obtaining a copy
+ *          of this software and associated documentation files (the "Software"), to deal
+ *          in the Software without restriction, including without limitation the rights
+ *          to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ *          of the Software, and to permit persons to whom the Software is furnished to do
+ *          so, subject to the following conditions:
+ *
+ *          2. The above copyright notice and this permission notice shall be included in all
+ *          copies or substantial portions of the Software.
+ *
+ *          3. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *          INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ *          PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *          HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ *          CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ *          OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#define WWEXACT_BOUND  256						//  default largest number of ones or zeros in the table
+
+
+/*
+ *     Table of the tails of the distribution of the number of runs
+ *     For every m <= n <= _bound and every number of runs r, the smaller of P(R <= r) and
+ *     P(R >= r) for a random sequence of m ones and n zeros.
+ */
+typedef struct
+{
+	double *_tail;
+	int     _bound;
+} WWTable;
+
+int    wwexact_init(WWTable *t, int bound);
+void   wwexact_free(WWTable *t);
+double wwexact_p(const WWTable *t, unsigned long long ones, unsigned long long zeros, unsigned long long runs);
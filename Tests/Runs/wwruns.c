@@ -7,14 +7,18 @@
  * Purpose: 
  *      To test for randomness in a sequence of numbers using the Wald-Wolfowits runs test.
  *
+ * Usage:
+ *      wwruns [n [seed]]
+ *
+ *      n is the number of values in the sequence, 10^9 by default. If there are at most
+ *      WWEXACT_BOUND ones and zeros, the p-value is exact, otherwise it is found from the
+ *      normal approximation.
+ *
  * Compilation:
- *     From the command line with Microsoft (R) Macro Assembler and 
- *                                Microsoft (R) C/C++ Optimizing Compiler.
+ *     From the command line with Microsoft (R) C/C++ Optimizing Compiler.
  *
- *      1. Assemble rng.asm without linking using the command
- *         ml /c rng.asm
- *      2. Compile and link the program using the command
- *         cl wwruns.c statistics.c rng.obj
+ *      1. Compile and link the program using the command
+ *         cl /O2 /openmp wwruns.c bitruns.c wwexact.c generator.c statistics.c
  *
  * License:
  * 
@@ -41,54 +45,84 @@
 
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <stdint.h>
 #include <math.h>
 
+#include "bitruns.h"
+#include "wwexact.h"
+#include "generator.h"
 #include "statistics.h"
 
 
-#define SEQUENCE   40
+#define N          1000000000ULL				//  default number of values
+#define SEED       0x13b3e					//  the initial seed of rng.asm
+#define CHUNK      (1 << 20)					//  values in a chunk, the unit of parallel work
+#define BLOCK      4096						//  values generated at a time
 #define ALPHA       0.05
 
 
-extern         void randomize(void);
-extern unsigned int rndmax();
-extern unsigned int rnd();
 
+/*
+ *     Summarize one chunk of the sequence, from its own position in the stream.
+ */
+static void summarize(RunsSummary *s, unsigned long long first, unsigned long long count, unsigned int seed)
+{
+	unsigned int x[BLOCK];
+	uint64_t     bits[BITRUNS_WORDS(BLOCK)];
+	Generator    g;
 
+	generator_init(&g, seed);
+	generator_jump(&g, first);
+	bitruns_summary_init(s);
 
-int main(void)
+	for (unsigned long long done = 0; done < count; done += BLOCK)
+	{
+		size_t m = (count - done < BLOCK) ? (size_t)(count - done) : BLOCK;
+		generator_fill(&g, x, m);
+		bitruns_pack(bits, x, m, GENERATOR_M / 2);			//  1 if above the mean rndmax() / 2.0
+		bitruns_summary_add(s, bits, m);
+	}
+}
+
+
+
+int main(int argc, char *argv[])
 {
-	randomize();		
-	
-	printf("\n\n\n               Wald-Wolfowitz runs test.\n\n\n   ");	
-	
-		//  declare and initialize variables used in the first step.
-	double   mean = (rndmax() / 2.0);
-	uint8_t  current = 2;								//  initialize to "impossible" value
-	uint8_t  runs    = 0;
-	uint8_t  ones    = 0;
-	uint8_t  value;
-	
-		//  Count ones and runs in a sequence of numbers generated by the RNG
-		//  If a number is higher than mean, count a 1.
-	for (int c = 0; c < SEQUENCE; c++)
+	unsigned long long total = (argc > 1) ? strtoull(argv[1], NULL, 0) : N;
+	unsigned int       seed  = (argc > 2) ? (unsigned int)strtoul(argv[2], NULL, 0) : SEED;
+	if (total < 2 || argc > 3)
+	{
+		printf("\n    Usage: wwruns [n [seed]], n >= 2\n\n");
+		return 1;
+	}
+
+		//  count ones, zeros and runs of every chunk in parallel, and stitch the chunks together
+	long long    chunks = (long long)((total + CHUNK - 1) / CHUNK);
+	RunsSummary *part   = (RunsSummary *)malloc(chunks * sizeof(RunsSummary));
+	RunsSummary  all;
+	if (part == NULL)
+	{
+		printf("\n    Unable to allocate memory.\n\n");
+		return 1;
+	}
+
+#pragma omp parallel for schedule(dynamic)
+	for (long long k = 0; k < chunks; k++)
 	{
-		value = (rnd() > mean);							//  get a 1 or a zero depending on the generated number
-		ones += value;								//  count ones
-		
-		printf(" %c ", value ? '+' : '-');					//  print sequence
-		
-		if (value != current)							//  count runs
-		{
-			runs++;
-			current = value;
-		}
+		unsigned long long first = (unsigned long long)k * CHUNK;
+		summarize(&part[k], first, (total - first < CHUNK) ? total - first : CHUNK, seed);
 	}
+
+	bitruns_summary_init(&all);
+	for (long long k = 0; k < chunks; k++) bitruns_summary_merge(&all, &part[k]);
+	free(part);
+	
+	printf("\n\n\n               Wald-Wolfowitz runs test.\n\n");	
 	
 		//  calculate expected runs and standard deviation
-	double    m = ones;								//  ones
-	double    n = SEQUENCE - ones;							//  zeros
+	double    m = (double)all._ones;						//  ones
+	double    n = (double)all._zeros;						//  zeros
 	double _2mn = 2.0 * m * n;							//  simplifies calculations
 	double   mn = m + n;								//  simplifies calculations					
 	
@@ -96,22 +130,32 @@ int main(void)
 	double VR = (_2mn * (_2mn - mn)) / (mn * mn * (mn - 1));			//  Variance of runs
 	double S  = sqrt(VR);								//  Standard deviation
 	
-		//  compute area under the normal curve with mean ER and standard deviation S between -runs and runs
-	double D = fabs(runs - ER);							//  difference between observed runs and expected runs
-	double P = 1.0 - statistics_cmnorm_tt(ER - D, ER + D, ER, S);			//  p-value is area outside the observed number of runs
+		//  p-value is the area under the normal curve further from ER than the observed number of runs
+	double P = (S > 0.0) ? statistics_pnorm_tt((all._runs - ER) / S) : 1.0;
+	double E = -1.0;
+	WWTable table;
+	
+		//  exact p-value of short sequences, from a table just large enough for the counts
+	int bound = (int)((all._ones > all._zeros) ? all._ones : all._zeros);
+	if (all._ones <= WWEXACT_BOUND && all._zeros <= WWEXACT_BOUND && wwexact_init(&table, bound) == 0)
+	{
+		E = wwexact_p(&table, all._ones, all._zeros, all._runs);
+		wwexact_free(&table);
+	}
 	
 		//  present analysis
-	printf("\n\n\n    H0: The number of runs indicates randomness.\n");
+	printf("\n    H0: The number of runs indicates randomness.\n");
 	printf("    HA: The number of runs indicates non-randomness.\n\n");
 	printf("    Alpha: %4.2f\n\n", ALPHA);
 	
-	printf("    Positive values:               %4u\n", ones);
-	printf("    Negative values:               %4u\n", SEQUENCE - ones);
-	printf("    Observed number of runs:       %4u\n", runs);
-	printf("    Expected number of runs:       %7.2f\n", ER);
-	printf("    Standard deviation:            %7.2f\n", S);
-	printf("    P-value:                       %7.2f\n", P);	
-	printf("    Reject H0 (P < Alpha)?         %4s\n\n\n", (P < ALPHA) ? "YES" : "NO");
+	printf("    Positive values:               %14llu\n", all._ones);
+	printf("    Negative values:               %14llu\n", all._zeros);
+	printf("    Observed number of runs:       %14llu\n", all._runs);
+	printf("    Expected number of runs:       %17.2f\n", ER);
+	printf("    Standard deviation:            %17.2f\n", S);
+	printf("    P-value, normal approximation: %17.4f\n", P);	
+	if (E >= 0.0) printf("    P-value, exact:                %17.4f\n", E), P = E;
+	printf("    Reject H0 (P < Alpha)?         %14s\n\n\n", (P < ALPHA) ? "YES" : "NO");
 	
 	return 0;
 }
@@ -0,0 +1,320 @@
+/*
+ * search.c
+ *
+ * Created: 18. Oct. 2026
+ *  Author: Frank Bjørnø
+ *
+ * Purpose:
+ *      Search for multipliers that could replace __a in rng.asm without changing anything
+ *      else in the generator. A candidate must give the full period, score well in the
+ *      spectral test in dimensions 2 - 8 and pass a short runs test.
+ *
+ * Usage:
+ *      search [first last]
+ *
+ *      Scans the multipliers a = 5 (mod 8) in [first, last]. By default the interval is
+ *      .01m < a < .99m, as recommended in rng.asm. Progress is saved to the file search.chk
+ *      after every batch of candidates, and a search that is interrupted continues from
+ *      there when the program is started again with the same interval.
+ *
+ * Compilation:
+ *     From the command line with Microsoft (R) C/C++ Optimizing Compiler.
+ *
+ *      1. Compile and link the program using the command
+ *         cl /O2 /openmp search.c spectral.c generator.c statistics.c
+ *
+ * License:
+ *
+ *          Copyright (C) 2026 Frank Bjørnø
+ *
+ *          1. Permission is hereby granted, free of charge, to any person obtaining a copy
+ *          of this software and associated documentation files (the "Software"), to deal
+ *          in the Software without restriction, including without limitation the rights
+ *          to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ *          of the Software, and to permit persons to whom the Software is furnished to do
+ *          so, subject to the following conditions:
+ *
+ *          2. The above copyright notice and this permission notice shall be included in all
+ *          copies or substantial portions of the Software.
+ *
+ *          3. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *          INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ *          PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *          HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ *          CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ *          OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "generator.h"
+#include "spectral.h"
+#include "statistics.h"
+
+#define MODULUS     (GENERATOR_M + 1ULL)				//  m = 2^31
+#define TOP         10						//  number of multipliers to keep
+#define BATCH       (1LL << 20)					//  candidates between checkpoints
+#define GRAIN       256						//  candidates handed to a thread at a time
+#define SEQUENCES   65536					//  16 bit sequences in the runs test
+#define ALPHA       0.001					//  significance level of the runs test
+#define CHECKPOINT  "search.chk"
+#define TEMPFILE    "search.chk.tmp"
+
+
+/*
+ *     A multiplier that has passed all stages, and its score
+ */
+typedef struct
+{
+	unsigned int _a;
+	double       _score;						//  smallest mu_t, t = 2, ..., 8
+	double       _mu[SPECTRAL_MAXDIM + 1];
+	double       _p;							//  p-value of the runs test
+} Candidate;
+
+static Candidate top[TOP];
+static int       ntop = 0;
+static double    worst = 0.0;						//  score to beat to enter the list, accessed atomically
+
+
+
+/*
+ *     Compare two candidates. The higher score is better, ties go to the lower multiplier
+ *     so the result does not depend on the order in which the threads find them.
+ */
+static int better(const Candidate *x, const Candidate *y)
+{
+	return (x -> _score > y -> _score) || (x -> _score == y -> _score && x -> _a < y -> _a);
+}
+
+
+
+/*
+ *     Insert a candidate into the sorted list of the best multipliers.
+ *
+ *     Note:  Must be called by one thread at a time.
+ */
+static void insert(const Candidate *c)
+{
+	if (ntop == TOP && !better(c, &top[TOP - 1])) return;
+
+	int i = (ntop < TOP) ? ntop++ : TOP - 1;
+
+	while (i > 0 && better(c, &top[i - 1]))
+	{
+		top[i] = top[i - 1];
+		i--;
+	}
+	top[i] = *c;
+#pragma omp atomic write
+	worst = (ntop == TOP) ? top[TOP - 1]._score : 0.0;
+}
+
+
+
+/*
+ *     Count the binary runs in sequences of 16 numbers from a generator with multiplier a,
+ *     as chiruns.c does with rng.asm, and compute the p-value of a chi square test.
+ */
+static double runs_test(unsigned int a)
+{
+	double observed[16] = {0}, expected[16], binomial = 1.0, X = 0.0;
+	unsigned int x = 0x13b3e, sequence, changes;
+	int runs;
+
+	for (int r = 0; r < 16; r++)
+	{
+		expected[r] = 2.0 * binomial * SEQUENCES / 65536.0;	//  2 * C(15, r) / 2^16 of the sequences
+		binomial = binomial * (15 - r) / (r + 1);
+	}
+
+	for (int n = 0; n < SEQUENCES; n++)
+	{
+		sequence = 0;
+		for (int c = 0; c < 16; c++)
+		{
+			x = (a * x + GENERATOR_C) & GENERATOR_M;
+			sequence |= (generator_hash(x) > GENERATOR_M / 2) << c;
+		}
+		changes = (sequence ^ (sequence >> 1)) & 0x7fff;
+		for (runs = 1; changes; changes &= changes - 1) runs++;
+		observed[runs - 1]++;
+	}
+
+	for (int r = 0; r < 16; r++) X += (observed[r] - expected[r]) * (observed[r] - expected[r]) / expected[r];
+	return 1.0 - statistics_cmchisq(X, 15);
+}
+
+
+
+/*
+ *     Examine one multiplier.
+ *
+ *     \param  a      The multiplier.
+ *     \param *c      Pointer to the candidate receiving the results.
+ *     \param  prune  If 0, all stages are carried out whatever the score.
+ *
+ *     \return        1 if it passed all stages, 0 if not.
+ *
+ *     Note:  The spectral test is carried out one dimension at a time, and the candidate is
+ *            dropped as soon as one mu_t falls below the worst score on the list. Most
+ *            candidates are dropped after the cheap tests in 2 and 3 dimensions.
+ */
+static int examine(unsigned int a, Candidate *c, int prune)
+{
+		//  full period: c is odd and a = 1 (mod 4)
+	if ((GENERATOR_C & 1) == 0 || (a & 3) != 1) return 0;
+
+	c -> _a = a;
+	c -> _score = 1e300;
+	for (int t = 2; t <= SPECTRAL_MAXDIM; t++)
+	{
+		double limit = 0.0;
+		if (prune)
+		{
+#pragma omp atomic read
+			limit = worst;
+		}
+
+		c -> _mu[t] = spectral_mu(spectral_nu2(a, MODULUS, t), MODULUS, t);
+		if (c -> _mu[t] < c -> _score) c -> _score = c -> _mu[t];
+		if (c -> _score < limit) return 0;
+	}
+
+	c -> _p = runs_test(a);
+	return c -> _p >= ALPHA && c -> _p <= 1.0 - ALPHA;
+}
+
+
+
+/*
+ *     Save the progress of the search.
+ *
+ *     Note:  The checkpoint is written to a temporary file that replaces search.chk only
+ *            when it is complete, so a search stopped while saving keeps the last one.
+ */
+static void save(long long first, long long last, long long next)
+{
+	FILE *fp = fopen(TEMPFILE, "w");
+	if (fp == NULL) return;
+
+	int ok = fprintf(fp, "%lld %lld %lld %d\n", first, last, next, ntop) > 0;
+	for (int i = 0; i < ntop && ok; i++)
+	{
+		ok = fprintf(fp, "%u %.17g", top[i]._a, top[i]._p) > 0;
+		for (int t = 2; t <= SPECTRAL_MAXDIM; t++) ok = ok && fprintf(fp, " %.17g", top[i]._mu[t]) > 0;
+		ok = ok && fprintf(fp, "\n") > 0;
+	}
+	if (fclose(fp) != 0 || !ok)
+	{
+		remove(TEMPFILE);
+		return;
+	}
+
+		//  rename does not replace an existing file on all systems
+	remove(CHECKPOINT);
+	rename(TEMPFILE, CHECKPOINT);
+}
+
+
+
+/*
+ *     Load the progress of an earlier search of the same interval.
+ *
+ *     \return    The next multiplier to examine, or first if there is no checkpoint.
+ */
+static long long load(long long first, long long last)
+{
+	long long f, l, next;
+	int n;
+	FILE *fp = fopen(CHECKPOINT, "r");
+	if (fp == NULL) return first;
+
+	if (fscanf(fp, "%lld %lld %lld %d", &f, &l, &next, &n) != 4 || f != first || l != last || n > TOP)
+	{
+		fclose(fp);
+		return first;
+	}
+	for (int i = 0; i < n; i++)
+	{
+		Candidate c;
+		if (fscanf(fp, "%u %lf", &c._a, &c._p) != 2) break;
+		c._score = 1e300;
+		int t;
+		for (t = 2; t <= SPECTRAL_MAXDIM; t++)
+		{
+			if (fscanf(fp, "%lf", &c._mu[t]) != 1) break;
+			if (c._mu[t] < c._score) c._score = c._mu[t];
+		}
+		if (t <= SPECTRAL_MAXDIM) break;		//  a truncated candidate is discarded
+		insert(&c);
+	}
+	fclose(fp);
+	return next;
+}
+
+
+
+int main(int argc, char *argv[])
+{
+	long long first = (long long)(0.01 * MODULUS), last = (long long)(0.99 * MODULUS);
+
+	if (argc == 3) first = strtoll(argv[1], NULL, 0), last = strtoll(argv[2], NULL, 0);
+	if (argc == 2 || argc > 3 || first < 0 || last >= (long long)MODULUS || first > last)
+	{
+		printf("\n    Usage: search [first last]\n\n");
+		return 1;
+	}
+
+		//  the first multiplier a = 5 (mod 8) in the interval
+	long long start = first + ((5 - first % 8) + 8) % 8;
+	long long next  = load(first, last);
+	if (next < start) next = start;
+
+	printf("\n\n    Searching multipliers a = 5 (mod 8) in [%lld, %lld]\n", first, last);
+	if (next > start) printf("    Continuing from %lld\n", next);
+
+	while (next <= last)
+	{
+		long long count = (last - next) / 8 + 1;
+		if (count > BATCH) count = BATCH;
+
+#pragma omp parallel for schedule(dynamic, GRAIN)
+		for (long long i = 0; i < count; i++)
+		{
+			Candidate c;
+			if (examine((unsigned int)(next + 8 * i), &c, 1))
+			{
+#pragma omp critical
+				insert(&c);
+			}
+		}
+
+		next += 8 * count;
+		save(first, last, next);
+		printf("\r    %6.2f %% done", 100.0 * (next - start) / (last - start + 8));
+		fflush(stdout);
+	}
+
+		//  present the best multipliers, and the one in rng.asm for comparison
+	Candidate current;
+	examine(GENERATOR_A, &current, 0);
+
+	printf("\n\n    %10s ", "a");
+	for (int t = 2; t <= SPECTRAL_MAXDIM; t++) printf("  mu_%d ", t);
+	printf("  %7s   %7s\n", "min", "P(runs)");
+	puts("    ------------------------------------------------------------------------------------");
+	for (int i = 0; i <= ntop; i++)
+	{
+		const Candidate *c = (i < ntop) ? &top[i] : &current;
+		if (i == ntop) puts("    ------------------------------------------------------------------------------------");
+		printf("    0x%08x ", c -> _a);
+		for (int t = 2; t <= SPECTRAL_MAXDIM; t++) printf(" %6.3f", c -> _mu[t]);
+		printf("   %7.4f   %7.4f%s\n", c -> _score, c -> _p, (i == ntop) ? "   rng.asm" : "");
+	}
+	puts("");
+
+	return 0;
+}
@@ -0,0 +1,165 @@
+/*
+ * level2.c
+ *
+ * Created: 18. Oct. 2026
+ *  Author: Frank Bjørnø
+ *
+ * Purpose:
+ *      Second level tests of the generator. Each first level test is repeated on independent
+ *      streams, and the p-values of the repetitions are tested for uniformity with the
+ *      Kolmogorov-Smirnov and the Anderson-Darling tests.
+ *
+ * Usage:
+ *      level2 [reps [seed]]
+ *
+ *      reps is the number of repetitions of each test, 1000 by default.
+ *
+ * Compilation:
+ *     From the command line with Microsoft (R) C/C++ Optimizing Compiler.
+ *
+ *      1. Compile and link the program using the command
+ *         cl /O2 /openmp level2.c secondlevel.c generator.c statistics.c
+ *
+ * License:
+ *
+ *          Copyright (C) 2026 Frank Bjørnø
+ *
+ *          1. Permission is hereby granted, free of charge, to any person obtaining a copy
+ *          of this software and associated documentation files (the "Software"), to deal
+ *          in the Software without restriction, including without limitation the rights
+ *          to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ *          of the Software, and to permit persons to whom the Software is furnished to do
+ *          so, subject to the following conditions:
+ *
+ *          2. The above copyright notice and this permission notice shall be included in all
+ *          copies or substantial portions of the Software.
+ *
+ *          3. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *          INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ *          PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *          HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ *          CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ *          OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+
+#include "generator.h"
+#include "statistics.h"
+#include "secondlevel.h"
+
+#define REPS        1000						//  default number of repetitions
+#define SEED        0x13b3e
+#define SEQUENCES   16384					//  16 bit sequences in the runs test
+#define LENGTH      400						//  numbers in the autocorrelation test
+#define DRAWS       10000					//  numbers in the frequency test
+#define CATEGORIES  10						//  outcomes in the frequency test
+
+
+
+/*
+ *     Runs test as in chiruns.c. The sequences with 0, 1 and 14, 15 changes are too rare for
+ *     the chi square test and are counted with their neighbours.
+ */
+static double runs_test(Generator *g, const void *ctx)
+{
+	double observed[14] = {0}, expected[14] = {0}, binomial = 1.0;
+	unsigned int sequence, changes;
+	int runs;
+	(void)ctx;
+
+	for (int r = 0; r < 16; r++)
+	{
+		expected[(r < 1) ? 0 : (r > 13) ? 13 : r - 1] += 2.0 * binomial * SEQUENCES / 65536.0;
+		binomial = binomial * (15 - r) / (r + 1);
+	}
+
+	for (int n = 0; n < SEQUENCES; n++)
+	{
+		sequence = 0;
+		for (int c = 0; c < 16; c++) sequence |= (generator_rnd(g) > GENERATOR_M / 2) << c;
+		changes = (sequence ^ (sequence >> 1)) & 0x7fff;
+		for (runs = 0; changes; changes &= changes - 1) runs++;
+		observed[(runs < 1) ? 0 : (runs > 13) ? 13 : runs - 1]++;
+	}
+
+	return statistics_csgof_p(observed, expected, 14);
+}
+
+
+
+/*
+ *     Autocorrelation at lag 1 as in acdist.c, with the known mean 1/2 and variance 1/12.
+ *     The products of neighbours are uncorrelated, so r * sqrt(n - 1) is approximately
+ *     standard normal.
+ */
+static double autocorrelation_test(Generator *g, const void *ctx)
+{
+	double data[LENGTH], sum = 0.0;
+	(void)ctx;
+
+	generator_fill_flt(g, data, LENGTH);
+	for (int c = 0; c < LENGTH - 1; c++) sum += (data[c] - 0.5) * (data[c + 1] - 0.5);
+
+	return statistics_pnorm_tt(12.0 * sum / sqrt(LENGTH - 1.0));
+}
+
+
+
+/*
+ *     Frequency test of the integers 1 - 10.
+ */
+static double frequency_test(Generator *g, const void *ctx)
+{
+	double observed[CATEGORIES] = {0}, expected[CATEGORIES];
+	(void)ctx;
+
+	for (int c = 0; c < CATEGORIES; c++) expected[c] = (double)DRAWS / CATEGORIES;
+	for (int n = 0; n < DRAWS; n++) observed[generator_rndint(g, 1, CATEGORIES) - 1]++;
+
+	return statistics_csgof_p(observed, expected, CATEGORIES);
+}
+
+
+
+int main(int argc, char *argv[])
+{
+	int          reps = (argc > 1) ? atoi(argv[1]) : REPS;
+	unsigned int seed = (argc > 2) ? (unsigned int)strtoul(argv[2], NULL, 0) : SEED;
+
+	const char         *names[] = {"runs", "autocorrelation", "frequency"};
+	TEST                tests[] = {runs_test, autocorrelation_test, frequency_test};
+	unsigned long long  count[] = {16 * SEQUENCES, LENGTH, DRAWS};
+	SecondLevel result;
+
+	if (argc > 3 || reps < 2)
+	{
+		printf("\n    Usage: level2 [reps [seed]], reps >= 2\n\n");
+		return 1;
+	}
+
+	printf("\n\n    %d repetitions of each test on streams in segments of %llu numbers, seed 0x%x\n\n", reps, secondlevel_spacing(reps), seed);
+	printf("    %-16s %10s %10s   %10s %10s\n", "test", "KS D", "P(D)", "AD A^2", "P(A^2)");
+	puts("    ----------------------------------------------------------------");
+	for (int t = 0; t < 3; t++)
+	{
+		switch (secondlevel_run(&result, NULL, reps, count[t], tests[t], NULL, seed))
+		{
+		case 1:
+			printf("\n    Unable to allocate memory.\n\n");
+			return 1;
+		case 2:
+			printf("    %-16s needs %llu numbers per repetition, too many for %d repetitions\n", names[t], count[t], reps);
+			continue;
+		}
+		printf("    %-16s %10.6f %10.4f   %10.6f %10.4f\n", names[t], result._ks, result._ks_p, result._ad, result._ad_p);
+	}
+	puts("    ----------------------------------------------------------------");
+	printf("    Small p-values indicate that the p-values of the test are not uniform.\n\n");
+
+	return 0;
+}
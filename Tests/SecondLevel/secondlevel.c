@@ -0,0 +1,133 @@
+/*
+ * secondlevel.c
+ *
+ * Created: 18. Oct. 2026
+ *  Author: Frank Bjørnø
+ *
+ * Purpose:
+ *      Repeat a test of the random number generator many times on independent streams,
+ *      and test whether the p-values of the repetitions are uniformly distributed.
+ *
+ * License:
+ *
+ *          Copyright (C) 2026 Frank Bjørnø
+ *
+ *          1. Permission is hereby granted, free of charge, to any person obtaining a copy
+ *          of this software and associated documentation files (the "Software"), to deal
+ *          in the Software without restriction, including without limitation the rights
+ *          to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ *          of the Software, and to permit persons to whom the Software is furnished to do
+ *          so, subject to the following conditions:
+ *
+ *          2. The above copyright notice and this permission notice shall be included in all
+ *          copies or substantial portions of the Software.
+ *
+ *          3. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *          INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ *          PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *          HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ *          CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ *          OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <stdlib.h>
+
+#include "secondlevel.h"
+#include "statistics.h"
+
+#define _PERIOD    (1ULL << 31)					//  the period of the generator
+
+
+
+/*
+ *     The distance between the starting points of the streams of two repetitions.
+ *
+ *     \param  reps   Number of repetitions.
+ *
+ *     \return        The largest number of values one repetition may draw without its
+ *                    stream running into the stream of the next repetition, or 0 if reps
+ *                    is less than 1.
+ */
+unsigned long long secondlevel_spacing(int reps)
+{
+	return (reps < 1) ? 0 : _PERIOD / reps;
+}
+
+
+
+/*
+ *     Find the first number of a repetition.
+ *
+ *     \param  r        The repetition.
+ *     \param  spacing  Length of the segment of the period given to each repetition.
+ *     \param  count    Numbers drawn by one repetition.
+ *     \param  seed     Seed of the first stream.
+ *
+ *     \return          The distance from the seed to the start of the stream.
+ *
+ *     Note:  The stream starts at a pseudo-random position within segment r. Streams that
+ *            start at exactly r * spacing lie on a lattice, because the jump from one to the
+ *            next is the same linear map, and a test of the p-values can then fail even
+ *            though each stream is fine.
+ */
+static unsigned long long _start(int r, unsigned long long spacing, unsigned long long count, unsigned int seed)
+{
+	unsigned long long slack = spacing - count + 1;
+	unsigned int       h = generator_hash((seed ^ (r * 0x9e3779b1u)) & GENERATOR_M);
+
+	return r * spacing + ((h * slack) >> 31);
+}
+
+
+
+/*
+ *     Run a test a number of times and test the uniformity of its p-values.
+ *
+ *     \param *result  Receives the number of repetitions and the Kolmogorov-Smirnov and
+ *                     Anderson-Darling statistics of the p-values, with their p-values.
+ *     \param *p       Array receiving the p-values of the repetitions. May be NULL.
+ *     \param  reps    Number of repetitions.
+ *     \param  count   The largest number of values one repetition draws.
+ *     \param  test    The first level test.
+ *     \param *ctx     Parameters passed to the test, may be NULL.
+ *     \param  seed    Seed of the first stream.
+ *
+ *     \return         0 on success, 1 if memory could not be allocated, 2 if reps is less
+ *                     than 1 or reps * count exceeds the period of the generator.
+ *
+ *     Note:  The period of the generator is split into reps equally long segments, and
+ *            repetition r draws its numbers from segment r, found by jumping ahead from the
+ *            seed. The streams never overlap. The repetitions run in parallel when compiled
+ *            with /openmp, and the p-values do not depend on the number of threads.
+ *
+ *     Note:  If the generator is good, the p-values are uniformly distributed on [0, 1],
+ *            and the p-values of the second level tests are not small. A first level test
+ *            that passes once may still fail this way, e.g. by passing too well too often.
+ */
+int secondlevel_run(SecondLevel *result, double *p, int reps, unsigned long long count, TEST test, const void *ctx, unsigned int seed)
+{
+	if (reps < 1) return 2;
+
+	unsigned long long spacing = secondlevel_spacing(reps);
+	if (count > spacing) return 2;
+
+	double *values = (p != NULL) ? p : (double *)malloc(reps * sizeof(double));
+	if (values == NULL) return 1;
+
+#pragma omp parallel for schedule(dynamic)
+	for (int r = 0; r < reps; r++)
+	{
+		Generator g;
+		generator_init(&g, seed);
+		generator_jump(&g, _start(r, spacing, count, seed));
+		values[r] = test(&g, ctx);
+	}
+
+	result -> _reps = reps;
+	result -> _ks_p = statistics_ks(values, reps, &result -> _ks);
+	result -> _ad_p = statistics_ad(values, reps, &result -> _ad);
+
+	if (p == NULL) free(values);
+	return (result -> _ks_p < 0.0 || result -> _ad_p < 0.0);
+}
@@ -0,0 +1,59 @@
+/*
+ * secondlevel.h
+ *
+ * Created: 18. Oct. 2026
+ *  Author: Frank Bjørnø
+ *
+ * Purpose:
+ *      Repeat a test of the random number generator many times on independent streams,
+ *      and test whether the p-values of the repetitions are uniformly distributed.
+ *
+ * License:
+ *
+ *          Copyright (C) 2026 Frank Bjørnø
+ *
+ *          1. Permission is hereby granted, free of charge, to any person obtaining a copy
+ *          of this software and associated documentation files (the "Software"), to deal
+ *          in the Software without restriction, including without limitation the rights
+ *          to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ *          of the Software, and to permit persons to whom the Software is furnished to do
+ *          so, subject to the following conditions:
+ *
+ *          2. The above copyright notice and this permission notice shall be included in all
+ *          copies or substantial portions of the Software.
+ *
+ *          3. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *          INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ *          PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *          HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ *          CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ *          OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include "generator.h"
+
+
+/*
+ *     Test
+ *     A first level test draws all its numbers from the generator it is given and returns
+ *     its p-value. It must not use rng.asm or any other global state, since repetitions are
+ *     run in parallel.
+ */
+typedef double (*TEST)(Generator *g, const void *ctx);
+
+
+/*
+ *     Result of a second level test
+ */
+typedef struct
+{
+	int    _reps;							//  number of repetitions
+	double _ks, _ks_p;						//  Kolmogorov-Smirnov statistic D and its p-value
+	double _ad, _ad_p;						//  Anderson-Darling statistic A^2 and its p-value
+} SecondLevel;
+
+int                secondlevel_run(SecondLevel *result, double *p, int reps, unsigned long long count, TEST test, const void *ctx, unsigned int seed);
+unsigned long long secondlevel_spacing(int reps);
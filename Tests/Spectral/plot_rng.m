@@ -28,34 +28,11 @@
 %           OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 %
 
-format = '%f,%f,%f';
-V = [];
-sizeV = [3 inf];
-
 %  --------------------------    Read Data    --------------------------
 
-	%  'rng_data.dat' should be in the same directory as this MatLab file
-fileID = fopen('rng_data.dat');
-
-if fileID == -1
-    disp('Error: Could not open file.')
-else
-    disp('File open for reading.')
-    
-    while ~feof(fileID)
-        V = fscanf(fileID, format, sizeV);
-    end
-    
-    closeresult = fclose(fileID);
-    if closeresult == 0;
-        disp ('File closed.')
-    else
-        disp('Could not close file.');
-    end
-end
-
-	% clean up
-clear closeresult fileID fmt sizeDATA
+	%  'rng_data.dat' should be in the same directory as this MatLab file, and so
+	%  should read_dataset.m from the Dataset folder. V is 3 x 50000, one point per column
+[V, INFO] = read_dataset('rng_data.dat');
 
 %  -----------------------     plot the data    ------------------------
 
@@ -6,8 +6,8 @@
  *
  * Purpose: 
  *      Generate 50000 random 3-coordinate points and store the data in a file.
- *      The numbers are rounded to two decimals. The data will be analyzed in
- *      Matlab.
+ *      The data will be analyzed in Matlab. The points are stored in full precision
+ *      in the binary format of dataset.c, with the seed in the header.
  *
  * Compilation:
  *     From the command line with Microsoft (R) Macro Assembler and 
@@ -16,7 +16,7 @@
  *      1. Assemble rng.asm without linking using the command
  *         ml /c rng.asm
  *      2. Compile and link the program using the command
- *         cl specdata.c rng.obj
+ *         cl specdata.c dataset.c rng.obj
  *
  * License:
  * 
@@ -43,19 +43,26 @@
 
 #include <stdio.h>
 
-extern   void randomize(voif);
-extern double rndflt(void);
+#include "dataset.h"
+
+#define N 50000
+
+extern unsigned int randomize(void);
+extern double       rndflt(void);
 
 int main(void)
 {
-	randomize();
+	static double point[3 * N];
+	unsigned int  seed = randomize();				//  randomize returns the new seed in EAX
+	DatasetWriter w;
 	
-	char *format = "%4.2f,%4.2f,%4.2f\n";	
-	FILE *datafile;	
-	datafile = fopen("rng_data.dat", "w");
+	for (int n = 0; n < 3 * N; n++) point[n] = rndflt();
 	
-	for (int n = 0; n < 50000; n++) fprintf(datafile, format, rndflt(), rndflt(), rndflt());							
-
-	fclose(datafile);	
+		//  store the points as N rows of 3 coordinates
+	if (dataset_create(&w, "rng_data.dat", DS_F64, 3, seed) != 0 || dataset_write(&w, point, N) != 0 || dataset_close(&w) != 0)
+	{
+		printf("\n    Unable to write rng_data.dat.\n\n");
+		return 1;
+	}
 	return 0;
 }
@@ -0,0 +1,86 @@
+/*
+ * spectest.c
+ *
+ * Created: 18. Oct. 2026
+ *  Author: Frank Bjørnø
+ *
+ * Purpose:
+ *      Perform Knuth's spectral test on the multiplier and modulus in rng.asm, or on any
+ *      other multiplier, in dimensions 2 - 8. Where specdata.c and plot_rng.m let one look
+ *      for hyperplanes in a cloud of points, this program computes the distance between
+ *      the hyperplanes directly.
+ *
+ * Usage:
+ *      spectest [a [m]]
+ *
+ *      E.g. spectest 65539 computes the test for RANDU, the generator in plot_randu.m.
+ *
+ * Compilation:
+ *     From the command line with Microsoft (R) C/C++ Optimizing Compiler.
+ *
+ *      1. Compile and link the program using the command
+ *         cl /O2 spectest.c spectral.c
+ *
+ * License:
+ *
+ *          Copyright (C) 2026 Frank Bjørnø
+ *
+ *          1. Permission is hereby granted, free of charge, to any person obtaining a copy
+ *          of this software and associated documentation files (the "Software"), to deal
+ *          in the Software without restriction, including without limitation the rights
+ *          to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ *          of the Software, and to permit persons to whom the Software is furnished to do
+ *          so, subject to the following conditions:
+ *
+ *          2. The above copyright notice and this permission notice shall be included in all
+ *          copies or substantial portions of the Software.
+ *
+ *          3. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *          INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ *          PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *          HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ *          CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ *          OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+
+#include "generator.h"
+#include "spectral.h"
+
+
+
+int main(int argc, char *argv[])
+{
+	unsigned long long a = GENERATOR_A;
+	unsigned long long m = GENERATOR_M + 1ULL;			//  __m in rng.asm is used as the mask m - 1
+
+	if (argc > 1) a = strtoull(argv[1], NULL, 0);
+	if (argc > 2) m = strtoull(argv[2], NULL, 0);
+
+	unsigned long long nu2[SPECTRAL_MAXDIM + 1];
+	clock_t t = clock();
+	for (int d = 2; d <= SPECTRAL_MAXDIM; d++) nu2[d] = spectral_nu2(a, m, d);
+	t = clock() - t;
+
+	printf("\n\n               Spectral test,  a = 0x%llx,  m = %llu\n\n", a, m);
+	printf("    %3s   %20s   %14s   %9s   %9s\n", "t", "nu_t^2", "nu_t", "log2 nu_t", "mu_t");
+	puts("    ------------------------------------------------------------------");
+	for (int d = 2; d <= SPECTRAL_MAXDIM; d++)
+	{
+		double nu = sqrt((double)nu2[d]);
+		printf("    %3d   %20llu   %14.2f   %9.2f   %9.4f\n", d, nu2[d], nu, log2(nu), spectral_mu(nu2[d], m, d));
+	}
+	puts("    ------------------------------------------------------------------");
+	printf("    Time: %.3f ms\n\n", 1000.0 * t / CLOCKS_PER_SEC);
+	printf("    log2 nu_t is the number of bits of accuracy in t dimensions. mu_t above 0.1\n");
+	printf("    is considered adequate and above 1.0 exceptionally good.\n\n");
+	printf("    Note: the test measures the lattice formed by the seeds Xn. The numbers returned\n");
+	printf("          by rnd() are the seeds with some of their bits shuffled.\n\n");
+
+	return 0;
+}
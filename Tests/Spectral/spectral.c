@@ -0,0 +1,251 @@
+/*
+ * spectral.c
+ *
+ * Created: 18. Oct. 2026
+ *  Author: Frank Bjørnø
+ *
+ * Purpose:
+ *      Knuth's spectral test of a linear congruential generator, computed by lattice
+ *      reduction.
+ *
+ * License:
+ *
+ *          Copyright (C) 2026 Frank Bjørnø
+ *
+ *          1. Permission is hereby granted, free of charge, to any person obtaining a copy
+ *          of this software and associated documentation files (the "Software"), to deal
+ *          in the Software without restriction, including without limitation the rights
+ *          to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ *          of the Software, and to permit persons to whom the Software is furnished to do
+ *          so, subject to the following conditions:
+ *
+ *          2. The above copyright notice and this permission notice shall be included in all
+ *          copies or substantial portions of the Software.
+ *
+ *          3. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *          INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ *          PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *          HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ *          CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ *          OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <math.h>
+
+#include "spectral.h"
+
+#define _PI          3.14159265359
+#define _DELTA       0.99						//  Lovász condition of the LLL reduction
+#define _SLACK       1e-9						//  relative margin on the floating point search bound
+
+typedef long long Basis[SPECTRAL_MAXDIM][SPECTRAL_MAXDIM];
+
+/*
+ *     State of the search for the shortest vector
+ */
+typedef struct
+{
+	int                _t;						//  dimension
+	const long long  (*_b)[SPECTRAL_MAXDIM];			//  reduced basis
+	double             _mu[SPECTRAL_MAXDIM][SPECTRAL_MAXDIM];	//  Gram-Schmidt coefficients
+	double             _B[SPECTRAL_MAXDIM];				//  squared lengths of the Gram-Schmidt vectors
+	long long          _x[SPECTRAL_MAXDIM];				//  coefficients of the current vector
+	unsigned long long _best;					//  shortest squared length found so far
+} Search;
+
+
+
+/*
+ *     Compute the Gram-Schmidt orthogonalization of a basis.
+ *
+ *     \param  b     The basis, one vector per row.
+ *     \param  t     Dimension.
+ *     \param  mu    Receives the coefficients mu[i][j] = <b_i, b*_j> / <b*_j, b*_j>.
+ *     \param  B     Receives the squared lengths <b*_i, b*_i>.
+ */
+static void _gram_schmidt(const long long b[][SPECTRAL_MAXDIM], int t, double mu[][SPECTRAL_MAXDIM], double B[])
+{
+	double bs[SPECTRAL_MAXDIM][SPECTRAL_MAXDIM], d;
+
+	for (int i = 0; i < t; i++)
+	{
+		for (int k = 0; k < t; k++) bs[i][k] = (double)b[i][k];
+		for (int j = 0; j < i; j++)
+		{
+			d = 0.0;
+			for (int k = 0; k < t; k++) d += (double)b[i][k] * bs[j][k];
+			mu[i][j] = d / B[j];
+			for (int k = 0; k < t; k++) bs[i][k] -= mu[i][j] * bs[j][k];
+		}
+		B[i] = 0.0;
+		for (int k = 0; k < t; k++) B[i] += bs[i][k] * bs[i][k];
+	}
+}
+
+
+
+/*
+ *     Exact squared length of a vector.
+ */
+static unsigned long long _norm2(const long long *v, int t)
+{
+	unsigned long long s = 0;
+	for (int k = 0; k < t; k++) s += (unsigned long long)(v[k] * v[k]);
+	return s;
+}
+
+
+
+/*
+ *     Reduce a basis with the Lenstra-Lenstra-Lovász algorithm.
+ *
+ *     Note:  The basis vectors are only ever changed by exact integer operations, so the
+ *            result is always a basis of the same lattice. The floating point Gram-Schmidt
+ *            coefficients only steer the reduction.
+ */
+static void _lll(long long b[][SPECTRAL_MAXDIM], int t)
+{
+	double mu[SPECTRAL_MAXDIM][SPECTRAL_MAXDIM], B[SPECTRAL_MAXDIM];
+	long long q, temp;
+	int k = 1;
+
+	_gram_schmidt(b, t, mu, B);
+	while (k < t)
+	{
+			//  size reduction of b_k
+		for (int j = k - 1; j >= 0; j--)
+		{
+			q = llround(mu[k][j]);
+			if (q == 0) continue;
+			for (int i = 0; i < t; i++) b[k][i] -= q * b[j][i];
+			_gram_schmidt(b, t, mu, B);
+		}
+
+			//  Lovász condition, swap b_k and b_k-1 if it fails
+		if (B[k] >= (_DELTA - mu[k][k - 1] * mu[k][k - 1]) * B[k - 1])
+		{
+			k++;
+			continue;
+		}
+		for (int i = 0; i < t; i++) temp = b[k][i], b[k][i] = b[k - 1][i], b[k - 1][i] = temp;
+		_gram_schmidt(b, t, mu, B);
+		if (k > 1) k--;
+	}
+}
+
+
+
+/*
+ *     Fincke-Pohst enumeration of the lattice vectors shorter than the best found so far.
+ *
+ *     \param *s     Pointer to the search state.
+ *     \param  k     Index of the coefficient to choose, from t - 1 down to 0.
+ *     \param  l     Squared length of the projection of the partial vector.
+ */
+static void _enumerate(Search *s, int k, double l)
+{
+	double c = 0.0, r, bound = s -> _best * (1.0 + _SLACK);
+
+	for (int j = k + 1; j < s -> _t; j++) c -= s -> _x[j] * s -> _mu[j][k];
+
+	r = sqrt((bound - l) / s -> _B[k]);
+	for (long long x = (long long)ceil(c - r); x <= (long long)floor(c + r); x++)
+	{
+		double d = l + (x - c) * (x - c) * s -> _B[k];
+		if (d > bound) continue;
+
+		s -> _x[k] = x;
+		if (k > 0)
+		{
+			_enumerate(s, k - 1, d);
+			bound = s -> _best * (1.0 + _SLACK);			//  the best may have improved
+			continue;
+		}
+
+			//  a complete vector, compute it and its length exactly
+		long long v[SPECTRAL_MAXDIM] = {0};
+		int zero = 1;
+		for (int j = 0; j < s -> _t; j++)
+		{
+			zero &= (s -> _x[j] == 0);
+			for (int i = 0; i < s -> _t; i++) v[i] += s -> _x[j] * s -> _b[j][i];
+		}
+		if (!zero && _norm2(v, s -> _t) < s -> _best)
+		{
+			s -> _best = _norm2(v, s -> _t);
+			bound = s -> _best * (1.0 + _SLACK);
+		}
+	}
+	s -> _x[k] = 0;
+}
+
+
+
+/*
+ *     Compute the square of the spectral test value nu_t of a linear congruential generator.
+ *
+ *     \param  a     Multiplier.
+ *     \param  m     Modulus, less than 2^32.
+ *     \param  t     Dimension, 2 - SPECTRAL_MAXDIM.
+ *
+ *     \return       nu_t^2, the squared length of the shortest nonzero vector (s1, ..., st)
+ *                   where s1 + s2*a + ... + st*a^(t-1) = 0 (mod m). 1/nu_t is the largest
+ *                   distance between the parallel hyperplanes covering the points
+ *                   (Xn, Xn+1, ..., Xn+t-1) / m. Returns 0 if t is out of range.
+ *
+ *     Note:  The lattice of the vectors s is reduced with the LLL algorithm, and the
+ *            shortest vector is then found by Fincke-Pohst enumeration. All vectors are
+ *            computed with exact 64 bit integer arithmetic.
+ *
+ *     Note:  The test depends only on a and m, not on the increment c.
+ */
+unsigned long long spectral_nu2(unsigned long long a, unsigned long long m, int t)
+{
+	if (t < 2 || t > SPECTRAL_MAXDIM) return 0;
+
+	Basis  b = {{0}};
+	Search s;
+	unsigned long long p = 1;
+
+		//  basis (m, 0, ..., 0) and (-a^j mod m, 0, ..., 1, ..., 0), j = 1, ..., t - 1,
+		//  with the residues centred on 0 to keep the numbers small
+	b[0][0] = (long long)m;
+	for (int j = 1; j < t; j++)
+	{
+		p = (p * (a % m)) % m;
+		long long r = (long long)p;
+		if (r > (long long)(m / 2)) r -= (long long)m;
+		b[j][0] = -r;
+		b[j][j] = 1;
+	}
+	_lll(b, t);
+
+	s._t = t;
+	s._b = (const long long (*)[SPECTRAL_MAXDIM])b;
+	s._best = _norm2(b[0], t);
+	for (int j = 1; j < t; j++) if (_norm2(b[j], t) < s._best) s._best = _norm2(b[j], t);
+	for (int j = 0; j < t; j++) s._x[j] = 0;
+	_gram_schmidt(s._b, t, s._mu, s._B);
+	_enumerate(&s, t - 1, 0.0);
+
+	return s._best;
+}
+
+
+
+/*
+ *     Compute Knuth's figure of merit mu_t, the volume of the t-dimensional sphere of
+ *     radius nu_t divided by m.
+ *
+ *     \param  nu2   nu_t^2 as returned by spectral_nu2.
+ *     \param  m     Modulus.
+ *     \param  t     Dimension.
+ *
+ *     \return       mu_t. Values above 0.1 are considered adequate and values above 1.0
+ *                   exceptionally good.
+ */
+double spectral_mu(unsigned long long nu2, unsigned long long m, int t)
+{
+	return pow(_PI, t / 2.0) * pow((double)nu2, t / 2.0) / (tgamma(t / 2.0 + 1.0) * (double)m);
+}
@@ -0,0 +1,332 @@
+/*
+ * acf.c
+ *
+ * Created: 18. Oct. 2026
+ *  Author: Frank Bjørnø
+ *
+ * Purpose:
+ *      Compute the autocorrelation of a series at all lags at once with the fast Fourier
+ *      transform, and the Ljung-Box and Box-Pierce tests of a range of lags.
+ *
+ * License:
+ *
+ *          Copyright (C) 2026 Frank Bjørnø
+ *
+ *          1. Permission is hereby granted, free of charge, to any person obtaining a copy
+ *          of this software and associated documentation files (the "Software"), to deal
+ *          in the Software without restriction, including without limitation the rights
+ *          to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ *          of the Software, and to permit persons to whom the Software is furnished to do
+ *          so, subject to the following conditions:
+ *
+ *          2. The above copyright notice and this permission notice shall be included in all
+ *          copies or substantial portions of the Software.
+ *
+ *          3. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *          INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ *          PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *          HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ *          CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ *          OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <stdlib.h>
+#include <math.h>
+
+#include "acf.h"
+
+#define _PI     3.14159265358979323846
+#define _CACHE  (1 << 14)					//  complex numbers transformed in the cache at a time
+
+
+
+/*
+ *     Put the entries of an array of complex numbers in bit reversed order.
+ *
+ *     \param *z    Array of n complex numbers, real and imaginary parts interleaved.
+ *     \param  n    Number of complex numbers, a power of 2.
+ */
+static void _bitreverse(double *z, size_t n)
+{
+	double temp;
+	for (size_t i = 1, j = 0; i < n; i++)
+	{
+		size_t bit = n >> 1;
+		for (; j & bit; bit >>= 1) j ^= bit;
+		j ^= bit;
+		if (i < j)
+		{
+			temp = z[2 * i],     z[2 * i]     = z[2 * j],     z[2 * j]     = temp;
+			temp = z[2 * i + 1], z[2 * i + 1] = z[2 * j + 1], z[2 * j + 1] = temp;
+		}
+	}
+}
+
+
+
+/*
+ *     Fill the table of twiddle factors of a radix-2 transform of n complex numbers.
+ *
+ *     \param *w    Array of 2n doubles, receiving e^(-2*pi*i*j / len) at w[len/2 + j],
+ *                  j = 0, ..., len/2 - 1, for len = 2, 4, ..., n, real and imaginary parts
+ *                  interleaved.
+ *     \param  n    Number of complex numbers, a power of 2.
+ *
+ *     Note:  The factors of each stage lie next to each other, so a stage reads its factors
+ *            in order rather than with a stride through one large table.
+ */
+static void _twiddles(double *w, size_t n)
+{
+	for (size_t j = 0; j < n / 2; j++)
+	{
+		w[2 * (n / 2 + j)]     =  cos(2.0 * _PI * j / n);
+		w[2 * (n / 2 + j) + 1] = -sin(2.0 * _PI * j / n);
+	}
+	for (size_t half = n / 4; half > 0; half >>= 1)
+	{
+		for (size_t j = 0; j < half; j++)
+		{
+			w[2 * (half + j)]     = w[2 * (2 * half + 2 * j)];
+			w[2 * (half + j) + 1] = w[2 * (2 * half + 2 * j) + 1];
+		}
+	}
+}
+
+
+
+/*
+ *     Carry out the butterfly stages of lengths first, 2*first, ..., last of a radix-2
+ *     transform.
+ *
+ *     \param *z      Array of n complex numbers, real and imaginary parts interleaved.
+ *     \param  n      Number of complex numbers, a power of 2.
+ *     \param *w      Table of twiddle factors filled by _twiddles.
+ */
+static void _stages(double *z, size_t n, const double *w, size_t first, size_t last)
+{
+	for (size_t len = first; len <= last; len <<= 1)
+	{
+		size_t half = len >> 1;
+		for (size_t i = 0; i < n; i += len)
+		{
+			double *a = z + 2 * i, *b = z + 2 * (i + half);
+			const double *t = w + 2 * half;
+			for (size_t j = 0; j < half; j++, a += 2, b += 2, t += 2)
+			{
+				double tr = b[0] * t[0] - b[1] * t[1];
+				double ti = b[0] * t[1] + b[1] * t[0];
+				b[0] = a[0] - tr, b[1] = a[1] - ti;
+				a[0] += tr,       a[1] += ti;
+			}
+		}
+	}
+}
+
+
+
+/*
+ *     Radix-2 fast Fourier transform of complex numbers, in place.
+ *
+ *     \param *z    Array of n complex numbers, real and imaginary parts interleaved.
+ *     \param  n    Number of complex numbers, a power of 2.
+ *     \param *w    Table of twiddle factors filled by _twiddles.
+ *
+ *     Note:  The stages up to length _CACHE are carried out one block of _CACHE numbers at a
+ *            time, while the block is in the cache, and only the longer stages pass over
+ *            the whole array.
+ */
+static void _fft(double *z, size_t n, const double *w)
+{
+	size_t block = (n < _CACHE) ? n : _CACHE;
+
+	_bitreverse(z, n);
+	for (size_t i = 0; i < n; i += block) _stages(z + 2 * i, block, w, 2, block);
+	_stages(z, n, w, 2 * block, n);
+}
+
+
+
+/*
+ *     One bin of the Fourier transform of N = 2n real numbers, from the transform of the
+ *     n complex numbers formed by taking the real numbers in pairs.
+ *
+ *     \param *z    Transform of the complex numbers x[2m] + i*x[2m + 1].
+ *     \param  n    Number of complex numbers.
+ *     \param  k    Bin, 0 - n.
+ *     \param  wr   Real part of e^(-2*pi*i*k / N).
+ *     \param  wi   Imaginary part of e^(-2*pi*i*k / N).
+ *     \param *re   Receives the real part of bin k.
+ *     \param *im   Receives the imaginary part of bin k.
+ *
+ *     Note:  With A = Z[k] and B = conj(Z[n - k]), the transforms of the even and odd
+ *            numbers are (A + B)/2 and (A - B)/2i, and X[k] = even + e^(-2*pi*i*k/N) * odd.
+ */
+static void _bin(const double *z, size_t n, size_t k, double wr, double wi, double *re, double *im)
+{
+	size_t i = k % n, j = (n - k) % n;
+	double ar = z[2 * i], ai = z[2 * i + 1];
+	double br = z[2 * j], bi = -z[2 * j + 1];
+	double evr = 0.5 * (ar + br), evi = 0.5 * (ai + bi);
+	double odr = 0.5 * (ai - bi), odi = -0.5 * (ar - br);
+
+	*re = evr + wr * odr - wi * odi;
+	*im = evi + wr * odi + wi * odr;
+}
+
+
+
+/*
+ *     The bins 0, ..., last of the Fourier transform of N = 2n real numbers.
+ *
+ *     \param *z      Transform of the complex numbers x[2m] + i*x[2m + 1].
+ *     \param  n      Number of complex numbers.
+ *     \param  last   Last bin, at most n.
+ *     \param *out    Receives |X[k]|^2 if power is not 0, Re X[k] if it is.
+ *
+ *     Note:  The factors e^(-2*pi*i*k / N) are found by rotating the previous factor, and
+ *            are computed directly every 64 bins so the rounding errors do not build up.
+ */
+static void _bins(const double *z, size_t n, size_t last, double *out, int power)
+{
+	double cr = cos(_PI / n), ci = -sin(_PI / n), wr = 1.0, wi = 0.0, temp, re, im;
+	for (size_t k = 0; k <= last; k++)
+	{
+		if (k % 64 == 0) wr = cos(_PI * k / n), wi = -sin(_PI * k / n);
+		_bin(z, n, k, wr, wi, &re, &im);
+		out[k] = power ? re * re + im * im : re;
+		temp = wr * cr - wi * ci;
+		wi   = wr * ci + wi * cr;
+		wr   = temp;
+	}
+}
+
+
+
+/*
+ *     Compute the sums of the lagged products of a series, for all lags up to maxlag.
+ *
+ *     \param *s       Array receiving s[k] = sum((x[t] - mean) * (x[t + k] - mean)), the sum
+ *                     taken over t = 0, ..., n - k - 1, for k = 0, ..., maxlag.
+ *     \param *x       The series.
+ *     \param  n       Length of the series.
+ *     \param  maxlag  The largest lag, less than n.
+ *     \param  mean    Subtracted from the series, e.g. the mean of the population or of x.
+ *
+ *     \return         0 on success, 1 if memory could not be allocated.
+ *
+ *     Note:  The series is padded with zeros to a power of 2, N >= n + maxlag, and the sums
+ *            are the inverse transform of the power spectrum |X|^2. This takes O(N log N)
+ *            operations whatever maxlag is, where computing each lag directly takes
+ *            O(n * maxlag). 20 bytes per padded entry, 2.5 arrays of N doubles, are
+ *            allocated; for n = 2^24 that is 640 MB.
+ *
+ *     Note:  Divide s[k] by n - k and the variance to get the coefficients computed by
+ *            statistics_acov, or by s[0] to get the coefficients of acf_correlation.
+ */
+int acf_sums(double *s, const double *x, size_t n, size_t maxlag, double mean)
+{
+	size_t N = 4, h;
+	while (N < n + maxlag) N <<= 1;
+	h = N / 2;
+
+	double *y = (double *)malloc(N * sizeof(double));
+	double *w = (double *)malloc(N * sizeof(double));
+	double *P = (double *)malloc((h + 1) * sizeof(double));
+	if (y == NULL || w == NULL || P == NULL)
+	{
+		free(y), free(w), free(P);
+		return 1;
+	}
+
+	_twiddles(w, h);
+
+		//  power spectrum of the padded series
+	for (size_t t = 0; t < n; t++) y[t] = x[t] - mean;
+	for (size_t t = n; t < N; t++) y[t] = 0.0;
+	_fft(y, h, w);
+	_bins(y, h, h, P, 1);
+
+		//  the power spectrum is real and symmetric, so its inverse transform is its
+		//  forward transform divided by N
+	for (size_t k = 0; k <= h; k++) y[k] = P[k];
+	for (size_t k = h + 1; k < N; k++) y[k] = P[N - k];
+	_fft(y, h, w);
+	_bins(y, h, maxlag, s, 0);
+	for (size_t k = 0; k <= maxlag; k++) s[k] /= N;
+
+	free(y), free(w), free(P);
+	return 0;
+}
+
+
+
+/*
+ *     Compute the sample autocorrelation coefficients of a series.
+ *
+ *     \param *r       Array receiving r[k], k = 0, ..., maxlag. r[0] is 1.
+ *     \param *x       The series.
+ *     \param  n       Length of the series.
+ *     \param  maxlag  The largest lag, less than n.
+ *
+ *     \return         0 on success, 1 if memory could not be allocated.
+ *
+ *     Note:  r[k] = sum((x[t] - m) * (x[t + k] - m)) / sum((x[t] - m)^2), where m is the mean
+ *            of x. These are the coefficients the portmanteau tests below expect.
+ */
+int acf_correlation(double *r, const double *x, size_t n, size_t maxlag)
+{
+	double m = 0.0;
+	for (size_t t = 0; t < n; t++) m += x[t];
+	m /= n;
+
+	if (acf_sums(r, x, n, maxlag, m)) return 1;
+	for (size_t k = maxlag; k > 0; k--) r[k] /= r[0];
+	r[0] = 1.0;
+	return 0;
+}
+
+
+
+/*
+ *     The Ljung-Box statistic of the autocorrelation coefficients in a range of lags.
+ *
+ *     \param *r       Autocorrelation coefficients as computed by acf_correlation.
+ *     \param  n       Length of the series.
+ *     \param  first   First lag, at least 1.
+ *     \param  last    Last lag.
+ *
+ *     \return         Q = n(n + 2) * sum(r[k]^2 / (n - k)), k = first, ..., last.
+ *
+ *     Note:  If the series is independent, Q is approximately chi square distributed with
+ *            last - first + 1 degrees of freedom, and the p-value of the test is
+ *            1 - statistics_cmchisq(Q, last - first + 1).
+ */
+double acf_ljung_box(const double *r, size_t n, size_t first, size_t last)
+{
+	double Q = 0.0;
+	for (size_t k = first; k <= last; k++) Q += r[k] * r[k] / (double)(n - k);
+	return (double)n * (n + 2.0) * Q;
+}
+
+
+
+/*
+ *     The Box-Pierce statistic of the autocorrelation coefficients in a range of lags.
+ *
+ *     \param *r       Autocorrelation coefficients as computed by acf_correlation.
+ *     \param  n       Length of the series.
+ *     \param  first   First lag, at least 1.
+ *     \param  last    Last lag.
+ *
+ *     \return         Q = n * sum(r[k]^2), k = first, ..., last.
+ *
+ *     Note:  The distribution of Q is the same as that of the Ljung-Box statistic, which is
+ *            closer to it for short series.
+ */
+double acf_box_pierce(const double *r, size_t n, size_t first, size_t last)
+{
+	double Q = 0.0;
+	for (size_t k = first; k <= last; k++) Q += r[k] * r[k];
+	return (double)n * Q;
+}
@@ -0,0 +1,219 @@
+/*
+ * bench.c
+ *
+ * Created: 18. Oct. 2026
+ *  Author: Frank Bjørnø
+ *
+ * Purpose:
+ *      Compare the speed and the accuracy of the descriptive statistics in statistics.c to
+ *      the plain loops they replaced, and check that the parallel sums are the same for any
+ *      number of threads.
+ *
+ * Usage:
+ *      bench [n]
+ *
+ *      n is the number of doubles in the data set, 10^9 by default. The data set takes
+ *      8 bytes per entry, so a smaller n is needed on machines with less than 12 GB of memory.
+ *
+ * Compilation:
+ *     From the command line with Microsoft (R) C/C++ Optimizing Compiler.
+ *
+ *      1. Compile and link the program using the command
+ *         cl /O2 /arch:AVX2 /openmp bench.c statistics.c generator.c
+ *
+ * License:
+ *
+ *          Copyright (C) 2026 Frank Bjørnø
+ *
+ *          1. Permission is hereby granted, free of charge, to any person obtaining a copy
+ *          of this software and associated documentation files (the "Software"), to deal
+ *          in the Software without restriction, including without limitation the rights
+ *          to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ *          of the Software, and to permit persons to whom the Software is furnished to do
+ *          so, subject to the following conditions:
+ *
+ *          2. The above copyright notice and this permission notice shall be included in all
+ *          copies or substantial portions of the Software.
+ *
+ *          3. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *          INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ *          PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *          HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ *          CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ *          OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+#include <time.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "statistics.h"
+#include "generator.h"
+
+#define N        1000000000LL					//  default size of the data set
+#define SEED     0x13b3e
+#define OFFSET   1000.0						//  added to the data to make cancellation visible
+#define RUNS     5							//  thread counts tried in the reproducibility test
+
+
+
+/*
+ *     The loops used before, for comparison
+ */
+static double old_mean(const double *data, int n)
+{
+	double sum = 0.0;
+	for (int c = 0; c < n; c++) sum += *data++;
+	return sum / n;
+}
+
+static double old_var(const double *data, int n)
+{
+	double sum = 0.0, m = old_mean(data, n);
+	for (int c = 0; c < n; c++) sum += pow(*data++ - m, 2);
+	return sum / (n - 1);
+}
+
+static double old_var_raw(const double *data, int n)
+{
+	double A = 0.0, B = 0.0;
+	for (int c = 0; c < n; c++) A += (*data * *data), B += *data++;
+	return (A - B*B/n) / (n - 1);
+}
+
+static double old_acov(const double *x, int size, int lag)
+{
+	double m = old_mean(x, size);
+	double sum = 0.0;
+	const double *y = x + lag;
+	for (int c = 0; c < size - lag; c++) sum += (*x++ - m) * (*y++ - m);
+	return sum / (size - lag - 1);
+}
+
+
+
+/*
+ *     The sum the compiler chooses the order of, for comparison
+ */
+static double unordered_sum(const double *data, long long n)
+{
+	double sum = 0.0;
+#pragma omp parallel for reduction(+:sum)
+	for (long long c = 0; c < n; c++) sum += data[c];
+	return sum;
+}
+
+
+
+/*
+ *     Wall clock time in seconds.
+ */
+static double seconds(void)
+{
+#ifdef _OPENMP
+	return omp_get_wtime();
+#else
+	return (double)clock() / CLOCKS_PER_SEC;
+#endif
+}
+
+
+
+/*
+ *     Print one line of the table.
+ */
+static void report(const char *name, double old, clock_t told, double now, clock_t tnow)
+{
+	double to = (double)told / CLOCKS_PER_SEC;
+	double tn = (double)tnow / CLOCKS_PER_SEC;
+	printf("    %-9s %9.3f s %9.3f s %7.2f x   %22.15e %22.15e\n", name, to, tn, to / tn, old, now);
+}
+
+
+
+int main(int argc, char *argv[])
+{
+	long long n = (argc > 1) ? strtoll(argv[1], NULL, 0) : N;
+	if (n < 2 || n > 0x7fffffffLL)
+	{
+		printf("\n    Usage: bench [n], 2 <= n < 2^31\n\n");
+		return 1;
+	}
+
+	double *data = malloc((size_t)n * sizeof(double));
+	if (data == NULL)
+	{
+		printf("\n    Unable to allocate %lld doubles, try a smaller n.\n\n", n);
+		return 1;
+	}
+
+	Generator g;
+	generator_init(&g, SEED);
+	generator_fill_flt(&g, data, (size_t)n);
+	for (long long c = 0; c < n; c++) data[c] += OFFSET;
+
+	clock_t t0, t1;
+	double  o, r, m, s;
+
+	printf("\n\n    %lld doubles, uniform on [%.0f, %.0f], var = 1/12 = %.15e\n\n", n, OFFSET, OFFSET + 1.0, 1.0 / 12.0);
+	printf("    %-9s %11s %11s %9s   %22s %22s\n", "", "old", "new", "speedup", "old", "new");
+	puts("    ----------------------------------------------------------------------------------------------");
+
+	t0 = clock(); o = old_mean(data, (int)n);          t0 = clock() - t0;
+	t1 = clock(); r = statistics_mean64(data, (size_t)n); t1 = clock() - t1;
+	report("mean", o, t0, r, t1);
+
+	t0 = clock(); o = old_var(data, (int)n);                       t0 = clock() - t0;
+	t1 = clock(); r = statistics_var64(data, (size_t)n, ST_SAMPLE); t1 = clock() - t1;
+	report("var", o, t0, r, t1);
+
+	t0 = clock(); o = old_var_raw(data, (int)n);                       t0 = clock() - t0;
+	t1 = clock(); r = statistics_var_raw64(data, (size_t)n, ST_SAMPLE); t1 = clock() - t1;
+	report("var_raw", o, t0, r, t1);
+
+	t0 = clock(); o = sqrt(old_var_raw(data, (int)n));         t0 = clock() - t0;
+	t1 = clock(); statistics_ds64(&m, &s, data, (size_t)n, ST_SAMPLE); t1 = clock() - t1;
+	report("ds", o * o, t0, s * s, t1);
+
+	t0 = clock(); o = old_acov(data, (int)n, 1);                        t0 = clock() - t0;
+	t1 = clock(); r = statistics_acov64(data, (size_t)n, 1, ST_SAMPLE); t1 = clock() - t1;
+	report("acov(1)", o, t0, r, t1);
+
+	puts("    ----------------------------------------------------------------------------------------------");
+	printf("    ds is compared to the one pass loop it replaced, and shows the variance.\n\n");
+
+		//  the sums with different numbers of threads
+	int    threads[RUNS] = {1, 2, 3, 4, 8};
+	double fixed[RUNS], loose[RUNS], tf, tl;
+
+	printf("\n    %7s   %24s %9s   %24s %9s\n", "threads", "fixed order", "time", "unordered", "time");
+	puts("    ----------------------------------------------------------------------------------");
+	for (int i = 0; i < RUNS; i++)
+	{
+#ifdef _OPENMP
+		omp_set_num_threads(threads[i]);
+#endif
+		tf = seconds(); fixed[i] = statistics_sum64(data, (size_t)n); tf = seconds() - tf;
+		tl = seconds(); loose[i] = unordered_sum(data, n);           tl = seconds() - tl;
+		printf("    %7d   %24.17e %7.3f s   %24.17e %7.3f s\n", threads[i], fixed[i], tf, loose[i], tl);
+	}
+	puts("    ----------------------------------------------------------------------------------");
+
+	int same = 1, loose_same = 1;
+	for (int i = 1; i < RUNS; i++)
+	{
+		same       &= (memcmp(&fixed[i], &fixed[0], sizeof(double)) == 0);
+		loose_same &= (memcmp(&loose[i], &loose[0], sizeof(double)) == 0);
+	}
+	printf("    Fixed order sums are %s, unordered sums are %s.\n\n",
+	       same ? "bit for bit identical" : "DIFFERENT", loose_same ? "identical" : "different");
+
+	free(data);
+	return 0;
+}
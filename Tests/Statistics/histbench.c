@@ -0,0 +1,138 @@
+/*
+ * histbench.c
+ *
+ * Created: 18. Oct. 2026
+ *  Author: Frank Bjørnø
+ *
+ * Purpose:
+ *      Compare the speed of counting with histogram.c to counting one value at a time into
+ *      an array of doubles, for tables of 16, 2^16 and 2^24 categories, and check that the
+ *      counts are the same.
+ *
+ * Usage:
+ *      histbench [n]
+ *
+ *      n is the number of values counted, 2^27 by default.
+ *
+ * Compilation:
+ *     From the command line with Microsoft (R) C/C++ Optimizing Compiler.
+ *
+ *      1. Compile and link the program using the command
+ *         cl /O2 /openmp histbench.c histogram.c statistics.c generator.c
+ *
+ * License:
+ *
+ *          Copyright (C) 2026 Frank Bjørnø
+ *
+ *          1. Permission is hereby granted, free of charge, to any person obtaining a copy
+ *          of this software and associated documentation files (the "Software"), to deal
+ *          in the Software without restriction, including without limitation the rights
+ *          to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ *          of the Software, and to permit persons to whom the Software is furnished to do
+ *          so, subject to the following conditions:
+ *
+ *          2. The above copyright notice and this permission notice shall be included in all
+ *          copies or substantial portions of the Software.
+ *
+ *          3. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *          INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ *          PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *          HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ *          CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ *          OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "histogram.h"
+#include "statistics.h"
+#include "generator.h"
+
+#define N        (1LL << 27)					//  default number of values
+#define SEED     0x13b3e
+#define TABLES   3
+
+
+
+/*
+ *     Wall clock time in seconds.
+ */
+static double seconds(void)
+{
+#ifdef _OPENMP
+	return omp_get_wtime();
+#else
+	return (double)clock() / CLOCKS_PER_SEC;
+#endif
+}
+
+
+
+int main(int argc, char *argv[])
+{
+	long long n = (argc > 1) ? strtoll(argv[1], NULL, 0) : N;
+	if (n < 1)
+	{
+		printf("\n    Usage: histbench [n], n > 0\n\n");
+		return 1;
+	}
+
+	unsigned int  bits[TABLES] = {4, 16, 24};
+	unsigned int *x   = (unsigned int *)malloc((size_t)n * sizeof(unsigned int));
+	double       *old = (double *)malloc(((size_t)1 << 24) * sizeof(double));
+	if (x == NULL || old == NULL)
+	{
+		printf("\n    Unable to allocate %lld values, try a smaller n.\n\n", n);
+		return 1;
+	}
+
+	printf("\n\n    %lld values\n\n", n);
+	printf("    %10s %11s %11s %9s   %8s %8s\n", "categories", "doubles", "histogram", "speedup", "same", "P");
+	puts("    ---------------------------------------------------------------------");
+
+	for (int t = 0; t < TABLES; t++)
+	{
+		size_t    size = (size_t)1 << bits[t];
+		Generator g;
+		Histogram h;
+
+			//  the top bits of the numbers are the categories
+		generator_init(&g, SEED);
+		generator_fill(&g, x, (size_t)n);
+		for (long long c = 0; c < n; c++) x[c] >>= 31 - bits[t];
+
+		if (histogram_init(&h, size))
+		{
+			printf("\n    Unable to allocate the histogram.\n\n");
+			return 1;
+		}
+
+		double t0 = seconds();
+		for (size_t k = 0; k < size; k++) old[k] = 0.0;
+		for (long long c = 0; c < n; c++) old[x[c]]++;
+		t0 = seconds() - t0;
+
+		double t1 = seconds();
+		histogram_add(&h, x, (size_t)n);
+		t1 = seconds() - t1;
+
+		int same = 1;
+		for (size_t k = 0; k < size; k++) same &= ((double)h._count[k] == old[k]);
+
+		printf("    %10zu %9.3f s %9.3f s %7.2f x   %8s %8.4f\n", size, t0, t1, t0 / t1,
+		       same ? "yes" : "NO", statistics_csgof_count(h._count, NULL, size));
+		histogram_free(&h);
+	}
+	puts("    ---------------------------------------------------------------------");
+	printf("    P is the p-value of a chi square test of the histogram, with equal expectations.\n\n");
+
+	free(old);
+	free(x);
+	return 0;
+}
@@ -0,0 +1,288 @@
+/*
+ * histogram.c
+ *
+ * Created: 18. Oct. 2026
+ *  Author: Frank Bjørnø
+ *
+ * Purpose:
+ *      Count how often each category occurs in large amounts of data, with integer counts,
+ *      for tables from a few cells up to 2^24 cells and more.
+ *
+ * License:
+ *
+ *          Copyright (C) 2026 Frank Bjørnø
+ *
+ *          1. Permission is hereby granted, free of charge, to any person obtaining a copy
+ *          of this software and associated documentation files (the "Software"), to deal
+ *          in the Software without restriction, including without limitation the rights
+ *          to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ *          of the Software, and to permit persons to whom the Software is furnished to do
+ *          so, subject to the following conditions:
+ *
+ *          2. The above copyright notice and this permission notice shall be included in all
+ *          copies or substantial portions of the Software.
+ *
+ *          3. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *          INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ *          PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *          HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ *          CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ *          OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+#ifdef _OPENMP
+#include <omp.h>
+#else
+#define omp_get_max_threads()  1
+#endif
+
+#include "histogram.h"
+
+#define _LANES     4						//  interleaved sub-histograms of small tables
+#define _SMALL     2048						//  largest table counted with interleaved sub-histograms
+#define _SHARD     (1 << 22)					//  largest table counted with one shard per thread
+#define _BATCH     (1ULL << 31)					//  values counted before the 32 bit shards are emptied
+#define _RANGE     14						//  log2 of the smallest number of cells in a bucket
+#define _BUCKETS   256						//  most buckets in the partition mode
+#define _BLOCK     (1 << 22)					//  values partitioned at a time
+
+
+
+/*
+ *     Prepare a histogram with all counts 0.
+ *
+ *     \param *h     Pointer to the histogram.
+ *     \param  size  Number of categories.
+ *
+ *     \return       0 on success, 1 if memory could not be allocated.
+ */
+int histogram_init(Histogram *h, size_t size)
+{
+	h -> _size  = size;
+	h -> _count = (unsigned long long *)calloc(size, sizeof(unsigned long long));
+	return h -> _count == NULL;
+}
+
+
+
+/*
+ *     Release the memory of a histogram.
+ */
+void histogram_free(Histogram *h)
+{
+	free(h -> _count);
+	h -> _count = NULL;
+	h -> _size  = 0;
+}
+
+
+
+/*
+ *     Set all counts to 0.
+ */
+void histogram_clear(Histogram *h)
+{
+	memset(h -> _count, 0, h -> _size * sizeof(unsigned long long));
+}
+
+
+
+/*
+ *     Count a piece of the data into a 32 bit shard.
+ *
+ *     \param *shard  lanes sub-histograms of size cells each, one after the other.
+ *     \param  lanes  Number of sub-histograms, 1 or _LANES.
+ *
+ *     Note:  Neighbouring values go to different sub-histograms. When the same category
+ *            comes up several times in a row, which is common with few categories, each
+ *            increment would otherwise have to wait for the store of the one before.
+ */
+static void _shard(unsigned int *shard, size_t size, int lanes, const unsigned int *x, size_t n)
+{
+	size_t c = 0;
+
+	if (lanes == _LANES)
+	{
+		unsigned int *s0 = shard, *s1 = s0 + size, *s2 = s1 + size, *s3 = s2 + size;
+		for (; c + 4 <= n; c += 4)
+		{
+			s0[x[c]]++;
+			s1[x[c + 1]]++;
+			s2[x[c + 2]]++;
+			s3[x[c + 3]]++;
+		}
+	}
+	for (; c < n; c++) shard[x[c]]++;
+}
+
+
+
+/*
+ *     Count with one shard per thread, and add the shards to the histogram.
+ *
+ *     \return   0 on success, 1 if memory could not be allocated.
+ */
+static int _sharded(Histogram *h, const unsigned int *x, size_t n)
+{
+	size_t        size   = h -> _size;
+	int           lanes  = (size <= _SMALL) ? _LANES : 1;
+	int           shards = omp_get_max_threads();
+	size_t        cells  = lanes * size;
+	unsigned int *shard;
+
+	if ((size_t)shards > n / size + 1) shards = (int)(n / size + 1);	//  not worth a shard each
+	shard = (unsigned int *)malloc(shards * cells * sizeof(unsigned int));
+	if (shard == NULL) return 1;
+
+	for (size_t done = 0; done < n; done += _BATCH)
+	{
+		size_t m = (n - done < _BATCH) ? n - done : _BATCH;
+
+#pragma omp parallel for schedule(static)
+		for (int s = 0; s < shards; s++)
+		{
+			size_t first = m * s / shards, last = m * (s + 1) / shards;
+			memset(shard + s * cells, 0, cells * sizeof(unsigned int));
+			_shard(shard + s * cells, size, lanes, x + done + first, last - first);
+		}
+
+			//  every thread merges a range of cells from all shards
+#pragma omp parallel for schedule(static)
+		for (long long k = 0; k < (long long)size; k++)
+		{
+			unsigned long long sum = 0;
+			for (size_t s = 0; s < cells * shards; s += size) sum += shard[s + k];
+			h -> _count[k] += sum;
+		}
+	}
+
+	free(shard);
+	return 0;
+}
+
+
+
+/*
+ *     Count by partitioning the values on their high bits first.
+ *
+ *     \return   0 on success, 1 if memory could not be allocated.
+ *
+ *     Note:  A table larger than the cache would cost a cache miss, often also a TLB miss,
+ *            for almost every value. Instead, a block of values is sorted into buckets of
+ *            neighbouring categories, and each bucket is then counted into a piece of the
+ *            table that fits in the cache. The buckets are counted in parallel, and since
+ *            they cover different cells, no shards are needed.
+ */
+static int _partitioned(Histogram *h, const unsigned int *x, size_t n)
+{
+	int    shift = _RANGE, pieces = omp_get_max_threads();
+	size_t block = (n < _BLOCK) ? n : _BLOCK;
+
+	while (((h -> _size - 1) >> shift) >= _BUCKETS) shift++;
+	int buckets = (int)((h -> _size - 1) >> shift) + 1;
+
+	unsigned int *sorted = (unsigned int *)malloc(block * sizeof(unsigned int));
+	size_t       *offset = (size_t *)malloc((pieces * buckets + 1) * sizeof(size_t));
+	if (sorted == NULL || offset == NULL)
+	{
+		free(sorted), free(offset);
+		return 1;
+	}
+
+	for (size_t done = 0; done < n; done += block)
+	{
+		size_t m = (n - done < block) ? n - done : block;
+		const unsigned int *y = x + done;
+
+			//  bucket sizes of each piece of the block
+#pragma omp parallel for schedule(static)
+		for (int p = 0; p < pieces; p++)
+		{
+			size_t *o = offset + p * buckets;
+			for (int b = 0; b < buckets; b++) o[b] = 0;
+			for (size_t c = m * p / pieces; c < m * (p + 1) / pieces; c++) o[y[c] >> shift]++;
+		}
+
+			//  where each piece writes each bucket, buckets in order, pieces in order within a bucket
+		size_t sum = 0, count;
+		for (int b = 0; b < buckets; b++)
+		{
+			for (int p = 0; p < pieces; p++)
+			{
+				count = offset[p * buckets + b];
+				offset[p * buckets + b] = sum;
+				sum += count;
+			}
+		}
+
+#pragma omp parallel for schedule(static)
+		for (int p = 0; p < pieces; p++)
+		{
+			size_t *o = offset + p * buckets;
+			for (size_t c = m * p / pieces; c < m * (p + 1) / pieces; c++) sorted[o[y[c] >> shift]++] = y[c];
+		}
+
+			//  after the scatter, the offsets of the last piece are the ends of the buckets
+#pragma omp parallel for schedule(dynamic)
+		for (int b = 0; b < buckets; b++)
+		{
+			size_t first = (b == 0) ? 0 : offset[(pieces - 1) * buckets + b - 1];
+			size_t last  = offset[(pieces - 1) * buckets + b];
+			unsigned long long *count = h -> _count;
+			for (size_t c = first; c < last; c++) count[sorted[c]]++;
+		}
+	}
+
+	free(sorted);
+	free(offset);
+	return 0;
+}
+
+
+
+/*
+ *     Count a set of values.
+ *
+ *     \param *h     Pointer to the histogram.
+ *     \param *x     The values, each less than the number of categories.
+ *     \param  n     Number of values.
+ *
+ *     \return       0 on success, 1 if memory could not be allocated, in which case the
+ *                   histogram is unchanged.
+ *
+ *     Note:  Tables of up to 2048 cells are counted with four interleaved sub-histograms per
+ *            thread, tables of up to 2^22 cells with one 32 bit sub-histogram per thread, and
+ *            larger tables by partitioning the values on their high bits first. Partitioning
+ *            pays only when the table is larger than the last level cache, since the values
+ *            are moved once more. The values are not checked.
+ */
+int histogram_add(Histogram *h, const unsigned int *x, size_t n)
+{
+	if (n == 0) return 0;
+	return (h -> _size <= _SHARD) ? _sharded(h, x, n) : _partitioned(h, x, n);
+}
+
+
+
+/*
+ *     Add the counts of another histogram with the same number of categories.
+ */
+void histogram_merge(Histogram *h, const Histogram *other)
+{
+	for (size_t k = 0; k < h -> _size; k++) h -> _count[k] += other -> _count[k];
+}
+
+
+
+/*
+ *     Compute the total of all counts.
+ */
+unsigned long long histogram_total(const Histogram *h)
+{
+	unsigned long long total = 0;
+	for (size_t k = 0; k < h -> _size; k++) total += h -> _count[k];
+	return total;
+}
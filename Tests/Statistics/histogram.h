@@ -0,0 +1,54 @@
+/*
+ * histogram.h
+ *
+ * Created: 18. Oct. 2026
+ *  Author: Frank Bjørnø
+ *
+ * Purpose:
+ *      Count how often each category occurs in large amounts of data, with integer counts,
+ *      for tables from a few cells up to 2^24 cells and more.
+ *
+ * License:
+ *
+ *          Copyright (C) 2026 Frank Bjørnø
+ *
+ *          1. Permission is hereby granted, free of charge, to any person obtaining a copy
+ *          of this software and associated documentation files (the "Software"), to deal
+ *          in the Software without restriction, including without limitation the rights
+ *          to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ *          of the Software, and to permit persons to whom the Software is furnished to do
+ *          so, subject to the following conditions:
+ *
+ *          2. The above copyright notice and this permission notice shall be included in all
+ *          copies or substantial portions of the Software.
+ *
+ *          3. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *          INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ *          PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *          HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ *          CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ *          OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <stddef.h>
+
+
+/*
+ *     Histogram
+ *     The counts of the categories 0, 1, ..., _size - 1.
+ */
+typedef struct
+{
+	unsigned long long *_count;
+	size_t              _size;
+} Histogram;
+
+int                histogram_init(Histogram *h, size_t size);
+void               histogram_free(Histogram *h);
+void               histogram_clear(Histogram *h);
+int                histogram_add(Histogram *h, const unsigned int *x, size_t n);
+void               histogram_merge(Histogram *h, const Histogram *other);
+unsigned long long histogram_total(const Histogram *h);
@@ -32,6 +32,8 @@
 
 #pragma once
 
+#include <stddef.h>
+
 typedef enum {ST_POPULATION = 0, ST_SAMPLE} SELECTION;
 
 	//  descriptive statistics
@@ -47,10 +49,47 @@ void   statistics_ds(double *mean, double *stddev, const double *data, int n, SE
 double statistics_cov(const double *x, const double *y, int n, SELECTION sel);
 double statistics_acov(double *x, int size, int lag, SELECTION sel);
 
+	//  descriptive statistics of arrays of more than 2^31 entries
+double statistics_sum64(const double *data, size_t n);
+double statistics_mean64(const double *data, size_t n);
+double statistics_var64(const double *data, size_t n, SELECTION sel);
+double statistics_var_raw64(const double *data, size_t n, SELECTION sel);
+void   statistics_ds64(double *mean, double *stddev, const double *data, size_t n, SELECTION sel);
+double statistics_cov64(const double *x, const double *y, size_t n, SELECTION sel);
+double statistics_acov64(const double *x, size_t size, size_t lag, SELECTION sel);
+
+	//  streaming descriptive statistics
+typedef struct
+{
+	unsigned long long _n;						//  number of values added
+	double _min, _max;
+	double _mean;
+	double _m2, _m3, _m4;						//  sums of the 2nd, 3rd and 4th powers of the deviations from the mean
+} Accumulator;
+
+void   statistics_acc_init(Accumulator *acc);
+void   statistics_acc_add(Accumulator *acc, double x);
+void   statistics_acc_merge(Accumulator *acc, const Accumulator *other);
+double statistics_acc_min(const Accumulator *acc);
+double statistics_acc_max(const Accumulator *acc);
+double statistics_acc_mean(const Accumulator *acc);
+double statistics_acc_var(const Accumulator *acc, SELECTION sel);
+double statistics_acc_std(const Accumulator *acc, SELECTION sel);
+double statistics_acc_skew(const Accumulator *acc);
+double statistics_acc_kurt(const Accumulator *acc);
+
 	//  distributions
 double statistics_cmnorm_ot(double z, double m, double s);
 double statistics_cmnorm_tt(double a, double b, double m, double s);
+double statistics_pnorm_tt(double z);
+void   statistics_pnorm_tt_batch(double *p, const double *z, size_t n);
 double statistics_cmchisq(double X, unsigned int df);
 
+double statistics_pchisq(double X, unsigned int df);
+
 	//  tests
 double statistics_csgof(double *obs, double *exp, int size, char *labels[], double alpha);
+double statistics_csgof_p(const double *obs, const double *exp, int size);
+double statistics_csgof_count(const unsigned long long *obs, const double *exp, size_t size);
+double statistics_ks(const double *u, int n, double *D);
+double statistics_ad(const double *u, int n, double *A2);